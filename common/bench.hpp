@@ -0,0 +1,122 @@
+#pragma once
+
+// Microbenchmark harness in the spirit of Google Benchmark, small enough to need nothing but the standard library.
+// BENCHMARK(name) { ... } defines a benchmark whose body runs `iterations` times; the runner grows iterations until
+// a run lasts long enough to time, then reports ns/op and heap allocations/op. Include from exactly one translation
+// unit: it replaces the global operator new to count allocations.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "replay.hpp"
+
+using namespace std;
+
+atomic<long> benchAllocations{0};
+
+void *operator new(size_t size) {
+    benchAllocations.fetch_add(1, memory_order_relaxed);
+    if (void *memory = malloc(size ? size : 1))
+        return memory;
+    throw bad_alloc();
+}
+
+void operator delete(void *memory) noexcept {
+    free(memory);
+}
+
+void operator delete(void *memory, size_t) noexcept {
+    free(memory);
+}
+
+struct Benchmark {
+    const char *name;
+    void (*run)(long iterations);
+};
+
+inline vector<Benchmark>& getBenchmarks() {
+    static vector<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+struct BenchmarkRegistration {
+    BenchmarkRegistration(const char *name, void (*run)(long)) { getBenchmarks().push_back(Benchmark{name, run}); }
+};
+
+// The function gets a prefix so a benchmark can carry the name of the code it measures.
+#define BENCHMARK(NAME)                                                                                                \
+    void benchmark_##NAME(long iterations);                                                                            \
+    static BenchmarkRegistration NAME##Registration(#NAME, benchmark_##NAME);                                          \
+    void benchmark_##NAME(long iterations)
+
+// Keeps the compiler from dropping a result nobody reads.
+template <typename T> void doNotOptimize(const T &value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+// Input recorded with -DRECORD_REPLAY, trimmed to the init lines and one turn. Exits when the file is missing, a
+// benchmark without its fixture measures nothing.
+inline string loadFixture(const char *path) {
+    ifstream file(path);
+    ReplayLog fixture;
+    if (!file || !fixture.load(file)) {
+        fprintf(stderr, "Can't read fixture %s\n", path);
+        exit(1);
+    }
+    return fixture.input;
+}
+
+// Splits off the first lineCount lines of text, returning them and leaving the rest in text.
+inline string takeLines(string &text, int lineCount) {
+    size_t end = 0;
+    for (int line = 0; line < lineCount && end != string::npos; line++) {
+        end = text.find('\n', end);
+        if (end != string::npos)
+            end++;
+    }
+    string head = text.substr(0, end);
+    text.erase(0, end);
+    return head;
+}
+
+// Runs every benchmark whose name contains filter, or all of them without one.
+inline int runBenchmarks(int argc, char **argv) {
+    const char *filter = argc > 1 ? argv[1] : "";
+    const double minimumSeconds = 0.2;
+    // The bots log their reasoning to stderr; millions of debug lines would flood the report and the timings would
+    // measure the stream rather than the code.
+    cerr.setstate(ios::badbit);
+
+    printf("%-32s %12s %12s %14s\n", "benchmark", "iterations", "ns/op", "allocations/op");
+    for (const Benchmark &benchmark : getBenchmarks()) {
+        if (!strstr(benchmark.name, filter))
+            continue;
+
+        long iterations = 1;
+        while (true) {
+            long allocationsBefore = benchAllocations.load();
+            auto start = chrono::steady_clock::now();
+            benchmark.run(iterations);
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            long allocations = benchAllocations.load() - allocationsBefore;
+
+            if (seconds >= minimumSeconds || iterations >= (1L << 40)) {
+                printf("%-32s %12ld %12.1f %14.2f\n", benchmark.name, iterations, seconds * 1e9 / iterations,
+                       static_cast<double>(allocations) / iterations);
+                break;
+            }
+            // Aim a bit past the minimum so the next run is most likely the last.
+            double scale = seconds > 0 ? minimumSeconds * 1.4 / seconds : 100;
+            iterations = max(iterations + 1, static_cast<long>(iterations * min(scale, 100.0)));
+        }
+    }
+    return 0;
+}
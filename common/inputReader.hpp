@@ -0,0 +1,131 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <istream>
+#include <string>
+#include <unistd.h>
+
+using namespace std;
+
+// Buffered reader that parses integers and tokens by hand. Reading stdin straight from its file descriptor into a
+// fixed buffer skips the locale and stdio sync work istream does for every field.
+class InputReader {
+public:
+    static InputReader& get() {
+        static InputReader stdinReader(STDIN_FILENO);
+        return stdinReader;
+    }
+
+    explicit InputReader(int fd) : fd(fd) {}
+    // Wraps any other stream (tests, recorded files). It pulls one character at a time from the stream buffer so
+    // nothing past the last parsed field is consumed when the reader goes away.
+    explicit InputReader(istream& in) : stream(&in) {}
+    // Parses text already in memory, such as benchmark fixtures. Anything past the buffer size is ignored.
+    explicit InputReader(const string& text) : size(min<int>(text.size(), BUFFER_SIZE)) {
+        memcpy(buffer, text.data(), size);
+    }
+
+    // Blocks until input is available. Returns EOF when there is none left.
+    int peek() {
+        if (position == size && !refill())
+            return EOF;
+        return buffer[position];
+    }
+
+    int readInt() {
+        int c = skipSpaces();
+        bool negative = c == '-';
+        if (negative) {
+            position++;
+            c = peek();
+        }
+
+        int value = 0;
+        while (c >= '0' && c <= '9') {
+            value = value * 10 + (c - '0');
+            position++;
+            c = peek();
+        }
+        return negative ? -value : value;
+    }
+
+    // Copies the next whitespace separated token into out, truncated to capacity - 1 characters and null terminated.
+    // Returns the token length.
+    int readToken(char *out, int capacity) {
+        int length = 0;
+        for (int c = skipSpaces(); c != EOF && c > ' '; c = peek()) {
+            if (length < capacity - 1)
+                out[length++] = c;
+            position++;
+        }
+        out[length] = '\0';
+        return length;
+    }
+
+    // Skips whitespace, then tells whether the input is over.
+    bool atEnd() {
+        return skipSpaces() == EOF;
+    }
+
+    // Hands every chunk read from the underlying input to tap, for recording matches.
+    void setTap(function<void(const char *, int)> newTap) {
+        tap = move(newTap);
+    }
+
+    void skipLine() {
+        for (int c = peek(); c != EOF; c = peek()) {
+            position++;
+            if (c == '\n')
+                break;
+        }
+    }
+
+private:
+    int skipSpaces() {
+        int c = peek();
+        while (c != EOF && c <= ' ') {
+            position++;
+            c = peek();
+        }
+        return c;
+    }
+
+    bool refill() {
+        position = 0;
+        size = 0;
+        if (stream) {
+            int c = stream->rdbuf()->sbumpc();
+            if (c == char_traits<char>::eof())
+                return false;
+            buffer[size++] = c;
+        } else if (fd >= 0) {
+            ssize_t bytesRead = ::read(fd, buffer, BUFFER_SIZE);
+            size = bytesRead > 0 ? bytesRead : 0;
+        }
+        if (size > 0 && tap)
+            tap(buffer, size);
+        return size > 0;
+    }
+
+    static const int BUFFER_SIZE = 1 << 16;
+
+    int fd = -1;
+    istream *stream = nullptr;
+    function<void(const char *, int)> tap;
+    int position = 0;
+    int size = 0;
+    char buffer[BUFFER_SIZE];
+};
+
+// Runs parse over the shared stdin reader when given cin, otherwise over a reader wrapping the stream.
+template <typename Parse> void parseWithReader(istream &in, Parse parse) {
+    if (&in == &cin) {
+        parse(InputReader::get());
+    } else {
+        InputReader reader(in);
+        parse(reader);
+    }
+}
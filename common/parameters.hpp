@@ -0,0 +1,59 @@
+#pragma once
+
+// Parameters the tuner searches. A bot lists them once in an X-macro of PARAMETER(type, name, value, lowest, highest)
+// entries, type being int or float. Regular builds declare each one a compile-time constant, so the merged
+// submission pays nothing for them. Builds with -DTUNABLE declare variables instead, and the bot overwrites them at
+// startup from a file of "name value" lines written by the tuner.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+#ifdef TUNABLE
+#define DECLARE_PARAMETER(TYPE, NAME, VALUE, LOWEST, HIGHEST) extern TYPE NAME;
+#define DEFINE_PARAMETER(TYPE, NAME, VALUE, LOWEST, HIGHEST) TYPE NAME = VALUE;
+#define PARAMETER_BINDING(TYPE, NAME, VALUE, LOWEST, HIGHEST)                                                          \
+    ParameterBinding{#NAME, [](double value) { NAME = static_cast<TYPE>(value); }},
+
+struct ParameterBinding {
+    const char *name;
+    void (*set)(double value);
+};
+
+// Applies a parameter file, reporting the names nobody registered.
+inline void readParameters(const char *path, const vector<ParameterBinding> &bindings) {
+    ifstream file(path);
+    if (!file)
+        fprintf(stderr, "Can't read parameters %s\n", path);
+    string name;
+    double value;
+    while (file >> name >> value) {
+        auto binding = find_if(bindings.begin(), bindings.end(),
+                               [&](const ParameterBinding &binding) { return name == binding.name; });
+        if (binding == bindings.end())
+            fprintf(stderr, "Unknown parameter %s\n", name.c_str());
+        else
+            binding->set(value);
+    }
+}
+#else
+#define DECLARE_PARAMETER(TYPE, NAME, VALUE, LOWEST, HIGHEST) const TYPE NAME = VALUE;
+#endif
+
+// What the tuner knows about a parameter: its current value and the range it may search.
+struct ParameterInfo {
+    bool isInteger() const { return strcmp(type, "int") == 0; }
+
+    const char *type;
+    const char *name;
+    double value;
+    double lowest;
+    double highest;
+};
+#define PARAMETER_INFO(TYPE, NAME, VALUE, LOWEST, HIGHEST)                                                             \
+    ParameterInfo{#TYPE, #NAME, static_cast<double>(VALUE), LOWEST, HIGHEST},
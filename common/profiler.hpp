@@ -0,0 +1,160 @@
+#pragma once
+
+// Scoped zone profiler. PROFILE_ZONE("name") times the rest of the enclosing scope. Zones nest, and the same name
+// under two different parents counts as two zones. PROFILE_DUMP() prints, for every zone in tree order, how often it
+// ran and its min/avg/p99/max time over the whole match. Bots don't see the end of a match on Codingame or under the
+// referee, so PROFILE_TURN() at the end of every turn also dumps every PROFILE_DUMP_TURNS turns, and after a turn
+// during which the process got SIGUSR1. All macros expand to nothing unless PROFILING is defined, so the merged
+// submission carries none of it. Zones are meant for the main thread only.
+#ifdef PROFILING
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#ifndef PROFILE_DUMP_TURNS
+#define PROFILE_DUMP_TURNS 50
+#endif
+
+using namespace std;
+
+class Profiler {
+public:
+    static Profiler& get() {
+        static Profiler profiler;
+        return profiler;
+    }
+
+    Profiler() {
+        signal(SIGUSR1, [](int) { dumpRequested = 1; });
+    }
+
+    void endTurn(FILE *out) {
+        turns++;
+        if (turns % PROFILE_DUMP_TURNS != 0 && !dumpRequested)
+            return;
+        dumpRequested = 0;
+        fprintf(out, "Profile after %d turns\n", turns);
+        dump(out);
+    }
+
+    int enter(const char *name) {
+        int zone = findChild(current, name);
+        current = zone;
+        return zone;
+    }
+
+    void leave(int zone, uint64_t nanoseconds) {
+        Zone &z = zones[zone];
+        z.count++;
+        z.total += nanoseconds;
+        z.min = min(z.min, nanoseconds);
+        z.max = max(z.max, nanoseconds);
+        z.histogram[getBucket(nanoseconds)]++;
+        current = z.parent;
+    }
+
+    void dump(FILE *out) const {
+        fprintf(out, "%-32s %8s %9s %9s %9s %9s\n", "zone (µs)", "count", "min", "avg", "p99", "max");
+        dumpChildren(out, ROOT, 0);
+    }
+
+private:
+    static constexpr int ROOT = -1;
+    // Four buckets per power of two, enough to place p99 within 25%.
+    static constexpr int BUCKET_COUNT = 64 * 4;
+
+    struct Zone {
+        const char *name;
+        int parent;
+        uint64_t count = 0;
+        uint64_t total = 0;
+        uint64_t min = UINT64_MAX;
+        uint64_t max = 0;
+        uint32_t histogram[BUCKET_COUNT] = {};
+    };
+
+    static int getBucket(uint64_t nanoseconds) {
+        if (nanoseconds < 4)
+            return nanoseconds;
+        int exponent = 63 - __builtin_clzll(nanoseconds);
+        return exponent * 4 + ((nanoseconds >> (exponent - 2)) & 3);
+    }
+
+    static uint64_t getBucketStart(int bucket) {
+        if (bucket < 4)
+            return bucket;
+        int exponent = bucket / 4;
+        return (uint64_t(4 + bucket % 4)) << (exponent - 2);
+    }
+
+    // Zone names are string literals, so comparing pointers is enough to tell call sites apart.
+    int findChild(int parent, const char *name) {
+        for (int zone = 0; zone < static_cast<int>(zones.size()); zone++)
+            if (zones[zone].parent == parent && zones[zone].name == name)
+                return zone;
+        zones.push_back(Zone{name, parent});
+        return zones.size() - 1;
+    }
+
+    uint64_t getPercentile(const Zone &zone, double fraction) const {
+        uint64_t rank = zone.count * fraction;
+        uint64_t seen = 0;
+        for (int bucket = 0; bucket < BUCKET_COUNT; bucket++) {
+            seen += zone.histogram[bucket];
+            // The bucket's upper bound, so the estimate errs on the slow side.
+            if (seen > rank)
+                return min(max(getBucketStart(bucket + 1) - 1, zone.min), zone.max);
+        }
+        return zone.max;
+    }
+
+    void dumpChildren(FILE *out, int parent, int depth) const {
+        for (int zone = 0; zone < static_cast<int>(zones.size()); zone++) {
+            const Zone &z = zones[zone];
+            if (z.parent != parent || z.count == 0)
+                continue;
+            fprintf(out, "%*s%-*s %8lu %9.1f %9.1f %9.1f %9.1f\n", depth * 2, "", 32 - depth * 2, z.name,
+                    static_cast<unsigned long>(z.count), z.min / 1e3, z.total / 1e3 / z.count,
+                    getPercentile(z, 0.99) / 1e3, z.max / 1e3);
+            dumpChildren(out, zone, depth + 1);
+        }
+    }
+
+    // Set from the signal handler, so nothing but a flag.
+    static inline volatile sig_atomic_t dumpRequested = 0;
+
+    vector<Zone> zones;
+    int current = ROOT;
+    int turns = 0;
+};
+
+class ProfileScope {
+public:
+    explicit ProfileScope(const char *name) : zone(Profiler::get().enter(name)), start(chrono::steady_clock::now()) {}
+    ~ProfileScope() {
+        auto elapsed = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+        Profiler::get().leave(zone, elapsed);
+    }
+
+private:
+    int zone;
+    chrono::steady_clock::time_point start;
+};
+
+#define PROFILE_CONCAT_INNER(A, B) A##B
+#define PROFILE_CONCAT(A, B) PROFILE_CONCAT_INNER(A, B)
+#define PROFILE_ZONE(NAME) ProfileScope PROFILE_CONCAT(_profileScope, __LINE__)(NAME)
+#define PROFILE_DUMP() Profiler::get().dump(stderr)
+#define PROFILE_TURN() Profiler::get().endTurn(stderr)
+
+#else
+
+#define PROFILE_ZONE(NAME)
+#define PROFILE_DUMP()
+#define PROFILE_TURN()
+
+#endif
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+using namespace std;
+
+// PCG32 (O'Neill, pcg-random.org): 64 bits of state, a multiply and a rotate per 32 bit number. Meets the
+// UniformRandomBitGenerator requirements, so the standard distributions and shuffle take it too.
+class FastRandom {
+public:
+    using result_type = uint32_t;
+
+    explicit FastRandom(uint64_t seed = 0) { this->seed(seed); }
+
+    void seed(uint64_t seed) {
+        state = 0;
+        (*this)();
+        state += seed;
+        (*this)();
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT32_MAX; }
+
+    result_type operator()() {
+        uint64_t old = state;
+        state = old * MULTIPLIER + INCREMENT;
+        uint32_t shifted = ((old >> 18) ^ old) >> 27;
+        uint32_t rotation = old >> 59;
+        return (shifted >> rotation) | (shifted << (-rotation & 31));
+    }
+
+    // Uniform in [0, range), range > 0. Lemire's multiply and shift, redrawing the few low products that would
+    // favor some results over others, so only those rare draws pay for a division.
+    uint32_t below(uint32_t range) {
+        uint64_t product = uint64_t((*this)()) * range;
+        if (uint32_t(product) < range) {
+            uint32_t threshold = -range % range;
+            while (uint32_t(product) < threshold)
+                product = uint64_t((*this)()) * range;
+        }
+        return product >> 32;
+    }
+
+private:
+    static constexpr uint64_t MULTIPLIER = 6364136223846793005ULL;
+    static constexpr uint64_t INCREMENT = 1442695040888963407ULL;
+
+    uint64_t state;
+};
+
+// Picks outcome i with probability weight i / total weight, for up to MAX_OUTCOMES outcomes added in order. Small
+// enough to live on the stack and be rebuilt for every draw site. With a handful of outcomes a cumulative table beats
+// the alias method: sampling counts the bounds at or below one bounded draw, a fixed loop without branches.
+template <int MAX_OUTCOMES> class WeightedSampler {
+public:
+    WeightedSampler() { clear(); }
+
+    void clear() {
+        bounds.fill(UINT32_MAX);
+        count = 0;
+        total = 0;
+    }
+
+    void add(uint32_t weight) {
+        total += weight;
+        bounds[count++] = total;
+    }
+
+    int size() const { return count; }
+    uint32_t totalWeight() const { return total; }
+
+    // The total weight must be positive. Outcomes of weight 0 are never picked.
+    int sample(FastRandom &random) const {
+        uint32_t draw = random.below(total);
+        int outcome = 0;
+        for (int i = 0; i < MAX_OUTCOMES; i++)
+            outcome += draw >= bounds[i];
+        return outcome;
+    }
+
+private:
+    // Running sums of the weights, UINT32_MAX past the last outcome so no draw gets there.
+    array<uint32_t, MAX_OUTCOMES> bounds;
+    int count;
+    uint32_t total;
+};
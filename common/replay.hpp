@@ -0,0 +1,149 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include "inputReader.hpp"
+#include "profiler.hpp"
+#include "turnBudget.hpp"
+
+using namespace std;
+
+// Line-oriented match log. Every raw input line is written as "R< line", every command line as "R> line" and every
+// turn ends with "R# turn <n> <µs>". The prefixes let the log share stderr with debug output, which is the only
+// thing Codingame lets us take home from a production match.
+const char REPLAY_INPUT_PREFIX[] = "R< ";
+const char REPLAY_OUTPUT_PREFIX[] = "R> ";
+const char REPLAY_TURN_PREFIX[] = "R# turn ";
+
+// Copies everything the stdin reader consumes and everything written to cout into a log. Does nothing until started,
+// so the per-turn calls can stay in the main loop of every build.
+class ReplayRecorder {
+public:
+    static ReplayRecorder& get() {
+        static ReplayRecorder recorder;
+        return recorder;
+    }
+
+    void start(ostream &out) {
+        log = &out;
+        InputReader::get().setTap([this](const char *data, int size) { write(input, data, size); });
+        output.target = cout.rdbuf();
+        output.recorder = this;
+        cout.rdbuf(&output);
+    }
+
+    void beginTurn() {
+        turnStart = chrono::steady_clock::now();
+    }
+
+    void endTurn() {
+        if (!log)
+            return;
+        cout.flush();
+        long elapsed = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - turnStart).count();
+        *log << REPLAY_TURN_PREFIX << turn++ << " " << elapsed << endl;
+    }
+
+private:
+    // Lines are only written once complete, so debug output on the same stream can't land in the middle of one.
+    struct Channel {
+        const char *prefix;
+        string pending;
+    };
+
+    // Forwards cout to its original buffer and records each character on the way.
+    struct TeeBuffer : streambuf {
+        int overflow(int c) override {
+            if (c == EOF)
+                return c;
+            char character = c;
+            recorder->write(recorder->commands, &character, 1);
+            return target->sputc(c);
+        }
+        int sync() override { return target->pubsync(); }
+
+        streambuf *target = nullptr;
+        ReplayRecorder *recorder = nullptr;
+    };
+
+    void write(Channel &channel, const char *data, int size) {
+        for (int i = 0; i < size; i++) {
+            if (data[i] != '\n') {
+                channel.pending += data[i];
+                continue;
+            }
+            *log << channel.prefix << channel.pending << '\n';
+            channel.pending.clear();
+        }
+    }
+
+    ostream *log = nullptr;
+    Channel input{REPLAY_INPUT_PREFIX, ""};
+    Channel commands{REPLAY_OUTPUT_PREFIX, ""};
+    TeeBuffer output;
+    chrono::steady_clock::time_point turnStart;
+    int turn = 0;
+};
+
+// A recorded match: the input to feed back and the time each turn took when it was recorded.
+struct ReplayLog {
+    bool load(istream &in) {
+        string line;
+        while (getline(in, line)) {
+            size_t found;
+            if ((found = line.find(REPLAY_INPUT_PREFIX)) != string::npos) {
+                input.append(line, found + sizeof(REPLAY_INPUT_PREFIX) - 1, string::npos);
+                input += '\n';
+            } else if ((found = line.find(REPLAY_TURN_PREFIX)) != string::npos) {
+                int turn;
+                long elapsed;
+                if (sscanf(line.c_str() + found + sizeof(REPLAY_TURN_PREFIX) - 1, "%d %ld", &turn, &elapsed) == 2)
+                    turnMicroseconds.push_back(elapsed);
+            }
+        }
+        return !input.empty();
+    }
+
+    string input;
+    vector<long> turnMicroseconds;
+};
+
+// Feeds a recorded match through the bot at full speed: init once, then turn until the input runs out. Prints each
+// turn's time next to the recorded one and returns non zero when the log can't be read.
+inline int runReplay(const char *path, function<void(InputReader &)> init, function<void(InputReader &)> turn) {
+    ifstream file(path);
+    ReplayLog replay;
+    if (!file || !replay.load(file)) {
+        fprintf(stderr, "Can't read a replay from %s\n", path);
+        return 1;
+    }
+
+    istringstream stream(replay.input);
+    InputReader in(stream);
+    init(in);
+    long total = 0;
+    long slowest = 0;
+    int turns = 0;
+    while (!in.atEnd()) {
+        TurnBudget::get().startTurn();
+        auto start = chrono::steady_clock::now();
+        turn(in);
+        long elapsed = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+        long recorded = turns < static_cast<int>(replay.turnMicroseconds.size()) ? replay.turnMicroseconds[turns] : -1;
+        fprintf(stderr, "Turn %d: %ldµs (recorded %ldµs)\n", turns, elapsed, recorded);
+        total += elapsed;
+        slowest = max(slowest, elapsed);
+        turns++;
+    }
+    fprintf(stderr, "%d turns, %ldµs total, %ldµs slowest\n", turns, total, slowest);
+    PROFILE_DUMP();
+    return 0;
+}
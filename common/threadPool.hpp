@@ -0,0 +1,141 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Fork-join pool with one task queue per worker. A worker drains its own queue from the front and, once empty,
+// steals from the back of the others. The calling thread is worker 0, so a pool of size 1 never starts a thread and
+// runs everything inline.
+class ThreadPool {
+public:
+    // threadCount <= 0 means one worker per hardware thread.
+    explicit ThreadPool(int threadCount) {
+        if (threadCount <= 0)
+            threadCount = max(1u, thread::hardware_concurrency());
+        queues = vector<WorkerQueue>(threadCount);
+        for (int worker = 1; worker < threadCount; worker++)
+            threads.emplace_back([this, worker]() { workerLoop(worker); });
+    }
+
+    ~ThreadPool() {
+        {
+            lock_guard<mutex> guard(stateLock);
+            stopping = true;
+        }
+        workAvailable.notify_all();
+        for (auto &worker : threads)
+            worker.join();
+    }
+
+    int workerCount() const {
+        return static_cast<int>(queues.size());
+    }
+
+    // Runs task(index, worker) for every index in [0, count) and returns once all of them finished. worker is in
+    // [0, workerCount()) and lets tasks pick per worker scratch data without locking.
+    void parallelFor(int count, function<void(int, int)> task) {
+        if (count <= 0)
+            return;
+        if (workerCount() == 1) {
+            for (int index = 0; index < count; index++)
+                task(index, 0);
+            return;
+        }
+
+        // Workers still scanning the queues of the previous round only take tasks of the round they claimed, and
+        // every one of those is done, so none of them touches job, pending or the refilled queues.
+        long round = generation + 1;
+        job = std::move(task);
+        pending = count;
+        for (int worker = 0; worker < workerCount(); worker++) {
+            WorkerQueue &queue = queues[worker];
+            lock_guard<mutex> queueGuard(queue.lock);
+            queue.generation = round;
+            queue.tasks.clear();
+            queue.head = 0;
+            for (int index = worker; index < count; index += workerCount())
+                queue.tasks.push_back(index);
+        }
+        {
+            lock_guard<mutex> guard(stateLock);
+            generation = round;
+        }
+        workAvailable.notify_all();
+
+        runTasks(0, round);
+        unique_lock<mutex> guard(stateLock);
+        allDone.wait(guard, [this]() { return pending == 0; });
+    }
+
+private:
+    struct WorkerQueue {
+        mutex lock;
+        vector<int> tasks;
+        int head = 0;
+        // The parallelFor round the tasks belong to.
+        long generation = 0;
+    };
+
+    bool popTask(int worker, long round, int &index) {
+        WorkerQueue &own = queues[worker];
+        {
+            lock_guard<mutex> guard(own.lock);
+            if (own.generation == round && own.head < static_cast<int>(own.tasks.size())) {
+                index = own.tasks[own.head++];
+                return true;
+            }
+        }
+        for (int offset = 1; offset < workerCount(); offset++) {
+            WorkerQueue &victim = queues[(worker + offset) % workerCount()];
+            lock_guard<mutex> guard(victim.lock);
+            if (victim.generation == round && victim.head < static_cast<int>(victim.tasks.size())) {
+                index = victim.tasks.back();
+                victim.tasks.pop_back();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void runTasks(int worker, long round) {
+        int index;
+        while (popTask(worker, round, index)) {
+            job(index, worker);
+            if (pending.fetch_sub(1) == 1) {
+                lock_guard<mutex> guard(stateLock);
+                allDone.notify_all();
+            }
+        }
+    }
+
+    void workerLoop(int worker) {
+        long seenGeneration = 0;
+        while (true) {
+            {
+                unique_lock<mutex> guard(stateLock);
+                workAvailable.wait(guard, [&]() { return stopping || generation != seenGeneration; });
+                if (stopping)
+                    return;
+                seenGeneration = generation;
+            }
+            runTasks(worker, seenGeneration);
+        }
+    }
+
+    vector<WorkerQueue> queues;
+    vector<thread> threads;
+    function<void(int, int)> job;
+    atomic<int> pending{0};
+    long generation = 0;
+    bool stopping = false;
+    mutex stateLock;
+    condition_variable workAvailable;
+    condition_variable allDone;
+};
@@ -0,0 +1,455 @@
+#pragma once
+
+// Local self-play. BotProcess drives a bot executable over pipes with the Codingame turn protocol, Match lets a
+// referee play one game between two of them with the real per-turn timeouts, and runTournament plays many seeded
+// matches on every core and reports the win rate with its 95% confidence interval and each bot's turn latency.
+// POSIX only, and never part of a submission.
+
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "threadPool.hpp"
+#include "turnBudget.hpp"
+
+using namespace std;
+
+class BotProcess {
+public:
+    BotProcess() = default;
+    BotProcess(const BotProcess &) = delete;
+    BotProcess &operator=(const BotProcess &) = delete;
+    ~BotProcess() { stop(); }
+
+    // Runs a command, an executable and its space separated arguments, with stdin and stdout on pipes and stderr
+    // discarded. A path that can't be executed shows up as a bot that never answers.
+    bool start(const string &command) {
+        vector<string> words;
+        for (size_t begin = command.find_first_not_of(' '); begin != string::npos;) {
+            size_t end = min(command.find(' ', begin), command.size());
+            words.push_back(command.substr(begin, end - begin));
+            begin = command.find_first_not_of(' ', end);
+        }
+        if (words.empty())
+            return false;
+        vector<char *> argv;
+        for (string &word : words)
+            argv.push_back(word.data());
+        argv.push_back(nullptr);
+
+        int input[2];
+        int output[2];
+        if (pipe2(input, O_CLOEXEC) != 0)
+            return false;
+        if (pipe2(output, O_CLOEXEC) != 0) {
+            close(input[0]);
+            close(input[1]);
+            return false;
+        }
+
+        // Other matches fork from other threads, so the child sticks to async-signal-safe calls.
+        pid = fork();
+        if (pid == 0) {
+            int devNull = open("/dev/null", O_WRONLY);
+            dup2(input[0], STDIN_FILENO);
+            dup2(output[1], STDOUT_FILENO);
+            if (devNull >= 0)
+                dup2(devNull, STDERR_FILENO);
+            execv(argv[0], argv.data());
+            _exit(127);
+        }
+
+        close(input[0]);
+        close(output[1]);
+        toBot = input[1];
+        fromBot = output[0];
+        if (pid < 0) {
+            stop();
+            return false;
+        }
+        return true;
+    }
+
+    void stop() {
+        if (toBot >= 0)
+            close(toBot);
+        if (fromBot >= 0)
+            close(fromBot);
+        toBot = fromBot = -1;
+        if (pid > 0) {
+            kill(pid, SIGKILL);
+            waitpid(pid, nullptr, 0);
+        }
+        pid = -1;
+    }
+
+    // False once the bot is gone.
+    bool send(const string &text) {
+        size_t written = 0;
+        while (written < text.size()) {
+            ssize_t count = write(toBot, text.data() + written, text.size() - written);
+            if (count < 0 && errno == EINTR)
+                continue;
+            if (count <= 0)
+                return false;
+            written += count;
+        }
+        return true;
+    }
+
+    int outputFd() const {
+        return fromBot;
+    }
+
+    // Reads whatever the bot has written so far, call it once poll() reports outputFd() readable. False at EOF.
+    bool receive() {
+        char chunk[4096];
+        ssize_t count;
+        do {
+            count = read(fromBot, chunk, sizeof(chunk));
+        } while (count < 0 && errno == EINTR);
+        if (count <= 0)
+            return false;
+        pending.append(chunk, count);
+        return true;
+    }
+
+    // The next complete output line without its line break, if one arrived.
+    optional<string> takeLine() {
+        size_t end = pending.find('\n');
+        if (end == string::npos)
+            return nullopt;
+        string line = pending.substr(0, end);
+        pending.erase(0, end + 1);
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        return line;
+    }
+
+private:
+    pid_t pid = -1;
+    int toBot = -1;
+    int fromBot = -1;
+    string pending;
+};
+
+// Turn response times in 1ms buckets. The first turn is kept apart, it has a much larger budget.
+struct LatencyHistogram {
+    static constexpr int BUCKET_COUNT = 101;
+
+    void add(bool firstTurn, long microseconds) {
+        if (firstTurn) {
+            firstTurnCount++;
+            firstTurnTotal += microseconds;
+            firstTurnMax = max(firstTurnMax, microseconds);
+            return;
+        }
+        buckets[min<long>(microseconds / 1000, BUCKET_COUNT - 1)]++;
+        count++;
+        total += microseconds;
+        maxMicroseconds = max(maxMicroseconds, microseconds);
+    }
+
+    void merge(const LatencyHistogram &other) {
+        for (int bucket = 0; bucket < BUCKET_COUNT; bucket++)
+            buckets[bucket] += other.buckets[bucket];
+        count += other.count;
+        total += other.total;
+        maxMicroseconds = max(maxMicroseconds, other.maxMicroseconds);
+        firstTurnCount += other.firstTurnCount;
+        firstTurnTotal += other.firstTurnTotal;
+        firstTurnMax = max(firstTurnMax, other.firstTurnMax);
+    }
+
+    // Upper bound in ms of the bucket holding the given fraction of turns.
+    long percentile(double fraction) const {
+        long rank = count * fraction;
+        long seen = 0;
+        for (int bucket = 0; bucket < BUCKET_COUNT; bucket++) {
+            seen += buckets[bucket];
+            if (seen > rank)
+                return bucket + 1;
+        }
+        return BUCKET_COUNT;
+    }
+
+    void print(FILE *out) const {
+        if (firstTurnCount > 0)
+            fprintf(out, "  first turn: avg %.1fms, max %.1fms\n", firstTurnTotal / 1e3 / firstTurnCount,
+                    firstTurnMax / 1e3);
+        if (count == 0)
+            return;
+        fprintf(out, "  other turns: avg %.1fms, p50 <%ldms, p90 <%ldms, p99 <%ldms, max %.1fms\n", total / 1e3 / count,
+                percentile(0.5), percentile(0.9), percentile(0.99), maxMicroseconds / 1e3);
+
+        long largest = *max_element(buckets.begin(), buckets.end());
+        for (int bucket = 0; bucket < BUCKET_COUNT; bucket++) {
+            if (buckets[bucket] == 0)
+                continue;
+            int width = max<long>(1, buckets[bucket] * 50 / largest);
+            fprintf(out, "  %3d%s ms %-50s %ld\n", bucket, bucket == BUCKET_COUNT - 1 ? "+" : " ",
+                    string(width, '#').c_str(), buckets[bucket]);
+        }
+    }
+
+    array<long, BUCKET_COUNT> buckets{};
+    long count = 0;
+    long total = 0;
+    long maxMicroseconds = 0;
+    long firstTurnCount = 0;
+    long firstTurnTotal = 0;
+    long firstTurnMax = 0;
+};
+
+struct TournamentOptions {
+    // Commands, see BotProcess::start().
+    array<string, 2> bots;
+    int games = 100;
+    uint64_t seed = 1;
+    // 0 runs one match per two hardware threads, as both bots of a match think at the same time.
+    int threads = 0;
+    long firstTurnTimeoutMilliseconds = TurnBudget::FIRST_TURN_LIMIT_MICROSECONDS / 1000;
+    long turnTimeoutMilliseconds = TurnBudget::TURN_LIMIT_MICROSECONDS / 1000;
+};
+
+// The two bots of one match, indexed by seat. Every turn both get their input and think at the same time. A bot
+// that crashes or misses the deadline is out of the match, which it then loses.
+class Match {
+public:
+    Match(const TournamentOptions &options, const array<string, 2> &commands) : options(options) {
+        for (int seat = 0; seat < 2; seat++)
+            failed[seat] = !bots[seat].start(commands[seat]);
+    }
+
+    bool isOver() const {
+        return failed[0] || failed[1];
+    }
+
+    // Sends each bot its input and collects lineCount output lines from it. False once a bot is out.
+    bool playTurn(const array<string, 2> &inputs, int lineCount, array<vector<string>, 2> &outputs) {
+        if (isOver())
+            return false;
+        bool firstTurn = turn++ == 0;
+        auto start = chrono::steady_clock::now();
+        auto deadline = start + chrono::milliseconds(firstTurn ? options.firstTurnTimeoutMilliseconds
+                                                               : options.turnTimeoutMilliseconds);
+
+        array<bool, 2> waiting;
+        for (int seat = 0; seat < 2; seat++) {
+            outputs[seat].clear();
+            failed[seat] = !bots[seat].send(inputs[seat]);
+            waiting[seat] = !failed[seat] && !takeLines(seat, lineCount, outputs[seat], firstTurn, start);
+        }
+
+        while (waiting[0] || waiting[1]) {
+            auto now = chrono::steady_clock::now();
+            if (now >= deadline)
+                break;
+            array<pollfd, 2> fds;
+            array<int, 2> slots{-1, -1};
+            int fdCount = 0;
+            for (int seat = 0; seat < 2; seat++)
+                if (waiting[seat]) {
+                    slots[seat] = fdCount;
+                    fds[fdCount++] = pollfd{bots[seat].outputFd(), POLLIN, 0};
+                }
+            int timeout = chrono::duration_cast<chrono::milliseconds>(deadline - now).count() + 1;
+            if (poll(fds.data(), fdCount, timeout) < 0 && errno != EINTR)
+                break;
+
+            for (int seat = 0; seat < 2; seat++) {
+                if (slots[seat] < 0 || !(fds[slots[seat]].revents & (POLLIN | POLLHUP | POLLERR)))
+                    continue;
+                if (!bots[seat].receive()) {
+                    waiting[seat] = false;
+                    failed[seat] = true;
+                } else {
+                    waiting[seat] = !takeLines(seat, lineCount, outputs[seat], firstTurn, start);
+                }
+            }
+        }
+
+        for (int seat = 0; seat < 2; seat++)
+            if (waiting[seat]) {
+                failed[seat] = true;
+                timedOut[seat] = true;
+            }
+        return !isOver();
+    }
+
+    array<bool, 2> failed{};
+    array<bool, 2> timedOut{};
+    array<LatencyHistogram, 2> latencies;
+
+private:
+    // Moves complete lines into output, recording the latency once the last one arrived.
+    bool takeLines(int seat, int lineCount, vector<string> &output, bool firstTurn,
+                   chrono::steady_clock::time_point start) {
+        while (static_cast<int>(output.size()) < lineCount) {
+            optional<string> line = bots[seat].takeLine();
+            if (!line)
+                return false;
+            output.push_back(*line);
+        }
+        auto elapsed = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+        latencies[seat].add(firstTurn, elapsed);
+        return true;
+    }
+
+    const TournamentOptions &options;
+    array<BotProcess, 2> bots;
+    int turn = 0;
+};
+
+struct MatchResult {
+    // Indexed by seat.
+    array<double, 2> scores{};
+    // Seat of the winner, -1 for a draw.
+    int winner = -1;
+    int turns = 0;
+};
+
+// Parses "[bot]... [--games N] [--seed S] [--threads T] [--first-timeout MS] [--timeout MS]" expecting botCount bots.
+// Flags it doesn't know go to gameFlag along with their value, which returns false to reject them.
+inline bool parseTournamentOptions(int argc, char **argv, int botCount, TournamentOptions &options,
+                                   function<bool(const string &, const char *)> gameFlag) {
+    int bots = 0;
+    for (int arg = 1; arg < argc; arg++) {
+        string flag = argv[arg];
+        if (flag.rfind("--", 0) != 0) {
+            if (bots == botCount)
+                return false;
+            options.bots[bots++] = flag;
+            continue;
+        }
+        if (arg + 1 == argc)
+            return false;
+        const char *value = argv[++arg];
+        if (flag == "--games")
+            options.games = atoi(value);
+        else if (flag == "--seed")
+            options.seed = strtoull(value, nullptr, 10);
+        else if (flag == "--threads")
+            options.threads = atoi(value);
+        else if (flag == "--first-timeout")
+            options.firstTurnTimeoutMilliseconds = atol(value);
+        else if (flag == "--timeout")
+            options.turnTimeoutMilliseconds = atol(value);
+        else if (!gameFlag(flag, value))
+            return false;
+    }
+    return bots == botCount && options.games > 0;
+}
+
+using PlayMatch = function<MatchResult(uint64_t, Match &)>;
+
+struct TournamentStats {
+    struct BotStats {
+        long wins = 0;
+        long draws = 0;
+        long losses = 0;
+        long timeouts = 0;
+        long crashes = 0;
+        LatencyHistogram latency;
+    };
+
+    // Bot A's share of the points, a draw counting half a win.
+    double score() const {
+        return (bots[0].wins + 0.5 * bots[0].draws) / games;
+    }
+
+    // Half width of the 95% confidence interval of score().
+    double margin() const {
+        double variance = max(0.0, scoreSquares / games - score() * score());
+        return 1.96 * sqrt(variance / games);
+    }
+
+    array<BotStats, 2> bots;
+    long games = 0;
+    long turns = 0;
+    double scoreSquares = 0;
+    double seconds = 0;
+    int threads = 0;
+};
+
+// Plays options.games matches in parallel. Games 2k and 2k+1 share seed + k with the seats swapped, so neither bot
+// profits from a lopsided map or from its seat.
+inline TournamentStats playTournament(const TournamentOptions &options, PlayMatch playMatch, bool showProgress) {
+    // A bot dying mid-write must not take the referee with it.
+    signal(SIGPIPE, SIG_IGN);
+
+    TournamentStats stats;
+    stats.threads = options.threads > 0 ? options.threads : max(1u, thread::hardware_concurrency() / 2);
+    mutex statsLock;
+    ThreadPool pool(stats.threads);
+    auto start = chrono::steady_clock::now();
+    pool.parallelFor(options.games, [&](int game, int) {
+        // Bot index for each seat.
+        array<int, 2> seats = game % 2 == 0 ? array<int, 2>{0, 1} : array<int, 2>{1, 0};
+        Match match(options, {options.bots[seats[0]], options.bots[seats[1]]});
+        MatchResult result = playMatch(options.seed + game / 2, match);
+        if (match.failed[0] != match.failed[1])
+            result.winner = match.failed[0] ? 1 : 0;
+        else if (match.failed[0])
+            result.winner = -1;
+
+        lock_guard<mutex> guard(statsLock);
+        for (int seat = 0; seat < 2; seat++) {
+            TournamentStats::BotStats &bot = stats.bots[seats[seat]];
+            if (result.winner == -1)
+                bot.draws++;
+            else if (result.winner == seat)
+                bot.wins++;
+            else
+                bot.losses++;
+            bot.timeouts += match.timedOut[seat];
+            bot.crashes += match.failed[seat] && !match.timedOut[seat];
+            bot.latency.merge(match.latencies[seat]);
+        }
+        double score = result.winner == -1 ? 0.5 : seats[result.winner] == 0;
+        stats.scoreSquares += score * score;
+        stats.turns += result.turns;
+        stats.games++;
+        if (showProgress)
+            fprintf(stderr, "\r%ld/%d games", stats.games, options.games);
+    });
+    stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    if (showProgress)
+        fprintf(stderr, "\n");
+    return stats;
+}
+
+// Plays a tournament and prints bot A's score with its confidence interval, both bots' results and their latency.
+inline int runTournament(const TournamentOptions &options, PlayMatch playMatch) {
+    TournamentStats stats = playTournament(options, playMatch, true);
+    double score = stats.score();
+    printf("%ld games, %.1f turns on average, %.1fs on %d threads\n", stats.games,
+           static_cast<double>(stats.turns) / stats.games, stats.seconds, stats.threads);
+    printf("A score %.1f%% +- %.1f%% (95%% confidence)", score * 100, stats.margin() * 100);
+    if (score > 0 && score < 1)
+        printf(", Elo difference %+.0f", -400 * log10(1 / score - 1) + 0.0);
+    printf("\n");
+    for (int bot = 0; bot < 2; bot++) {
+        const TournamentStats::BotStats &s = stats.bots[bot];
+        printf("%c %s: %ld wins, %ld draws, %ld losses, %ld timeouts, %ld crashes\n", 'A' + bot,
+               options.bots[bot].c_str(), s.wins, s.draws, s.losses, s.timeouts, s.crashes);
+        s.latency.print(stdout);
+    }
+    return 0;
+}
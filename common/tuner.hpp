@@ -0,0 +1,178 @@
+#pragma once
+
+// SPSA (simultaneous perturbation stochastic approximation) over a bot's tunable parameters, see parameters.hpp.
+// Each iteration nudges every parameter at once in a random +-1 direction, plays the two opposite nudges against
+// each other in a batch of parallel self-play games, and moves along that direction in proportion to the score
+// difference. Noisy game results are all it needs. The result then plays the starting values and is written back as
+// the generated header only if it beat them.
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "parameters.hpp"
+#include "tournament.hpp"
+
+struct TunerOptions {
+    int iterations = 100;
+    int verifyGames = 200;
+    string output = "tunedParameters.hpp";
+};
+
+// Parameter values are searched mapped to [0, 1] between their bounds, so one step size fits all of them.
+inline double denormalizeParameter(const ParameterInfo &parameter, double position) {
+    double value = parameter.lowest + position * (parameter.highest - parameter.lowest);
+    return parameter.isInteger() ? round(value) : value;
+}
+
+inline bool writeParameterFile(const string &path, const vector<ParameterInfo> &parameters,
+                               const vector<double> &positions) {
+    FILE *file = fopen(path.c_str(), "w");
+    if (!file)
+        return false;
+    for (size_t i = 0; i < parameters.size(); i++)
+        fprintf(file, "%s %.6g\n", parameters[i].name, denormalizeParameter(parameters[i], positions[i]));
+    return fclose(file) == 0;
+}
+
+inline string formatParameterValue(const ParameterInfo &parameter, double value) {
+    if (parameter.isInteger())
+        return to_string(static_cast<long>(value));
+    char text[32];
+    snprintf(text, sizeof(text), "%.4g", value);
+    string literal = text;
+    if (literal.find_first_of(".e") == string::npos)
+        literal += ".0";
+    return literal + "f";
+}
+
+inline bool writeTunedHeader(const string &path, const vector<ParameterInfo> &parameters,
+                             const vector<double> &positions, const string &provenance) {
+    FILE *file = fopen(path.c_str(), "w");
+    if (!file)
+        return false;
+    fprintf(file, "#pragma once\n\n%s\nnamespace Tuned {\n", provenance.c_str());
+    for (size_t i = 0; i < parameters.size(); i++) {
+        double value = denormalizeParameter(parameters[i], positions[i]);
+        fprintf(file, "    const %s %s = %s;\n", parameters[i].type, parameters[i].name,
+                formatParameterValue(parameters[i], value).c_str());
+    }
+    fprintf(file, "}\n");
+    return fclose(file) == 0;
+}
+
+// Parses "<tunable bot> [--iterations N] [--games N] [--verify-games N] [--output PATH]" plus the tournament flags,
+// passing the rest to gameFlag. --games counts per iteration.
+inline bool parseTunerOptions(int argc, char **argv, TournamentOptions &options, TunerOptions &tuner,
+                              function<bool(const string &, const char *)> gameFlag) {
+    options.games = 16;
+    bool parsed = parseTournamentOptions(argc, argv, 1, options, [&](const string &flag, const char *value) {
+        if (flag == "--iterations")
+            tuner.iterations = atoi(value);
+        else if (flag == "--verify-games")
+            tuner.verifyGames = atoi(value);
+        else if (flag == "--output")
+            tuner.output = value;
+        else
+            return gameFlag(flag, value);
+        return true;
+    });
+    return parsed && tuner.iterations > 0 && tuner.verifyGames > 0;
+}
+
+// Tunes, then writes the header. The bot, options.bots[0], must be a -DTUNABLE build: it gets the parameter file to
+// play with as its argument.
+inline int runTuner(const TournamentOptions &options, const TunerOptions &tuner,
+                    const vector<ParameterInfo> &parameters, PlayMatch playMatch) {
+    // Initial nudge and step, both in normalized units, and their decay from Spall's SPSA guidelines.
+    const double PERTURBATION = 0.1;
+    const double LEARNING_RATE = 0.01;
+    const double PERTURBATION_DECAY = 0.101;
+    const double STEP_DECAY = 0.602;
+
+    char directory[] = "/tmp/tunerXXXXXX";
+    if (!mkdtemp(directory)) {
+        perror("mkdtemp");
+        return 1;
+    }
+    string bot = options.bots[0];
+    string startPath = string(directory) + "/start";
+    string plusPath = string(directory) + "/plus";
+    string minusPath = string(directory) + "/minus";
+    string tunedPath = string(directory) + "/tuned";
+
+    int count = parameters.size();
+    vector<double> start(count);
+    for (int i = 0; i < count; i++) {
+        const ParameterInfo &parameter = parameters[i];
+        start[i] = clamp((parameter.value - parameter.lowest) / (parameter.highest - parameter.lowest), 0.0, 1.0);
+    }
+    writeParameterFile(startPath, parameters, start);
+
+    vector<double> tuned = start;
+    vector<double> plus(count);
+    vector<double> minus(count);
+    vector<int> direction(count);
+    mt19937_64 random(options.seed);
+    double stability = 0.1 * tuner.iterations;
+    for (int iteration = 1; iteration <= tuner.iterations; iteration++) {
+        double perturbation = PERTURBATION / pow(iteration, PERTURBATION_DECAY);
+        double step = LEARNING_RATE * pow((1 + stability) / (iteration + stability), STEP_DECAY);
+        for (int i = 0; i < count; i++) {
+            direction[i] = random() & 1 ? 1 : -1;
+            plus[i] = clamp(tuned[i] + perturbation * direction[i], 0.0, 1.0);
+            minus[i] = clamp(tuned[i] - perturbation * direction[i], 0.0, 1.0);
+        }
+        writeParameterFile(plusPath, parameters, plus);
+        writeParameterFile(minusPath, parameters, minus);
+
+        TournamentOptions batch = options;
+        batch.bots = {bot + " " + plusPath, bot + " " + minusPath};
+        batch.seed = options.seed + static_cast<uint64_t>(iteration) * options.games;
+        TournamentStats stats = playTournament(batch, playMatch, false);
+
+        // The score difference between the nudges over their distance estimates the slope along direction.
+        double slope = (2 * stats.score() - 1) / (2 * perturbation);
+        fprintf(stderr, "iteration %d/%d, plus scored %.0f%%:", iteration, tuner.iterations, stats.score() * 100);
+        for (int i = 0; i < count; i++) {
+            tuned[i] = clamp(tuned[i] + step * slope * direction[i], 0.0, 1.0);
+            fprintf(stderr, " %s=%g", parameters[i].name, denormalizeParameter(parameters[i], tuned[i]));
+        }
+        fprintf(stderr, "\n");
+    }
+
+    writeParameterFile(tunedPath, parameters, tuned);
+    TournamentOptions check = options;
+    check.games = tuner.verifyGames;
+    check.bots = {bot + " " + tunedPath, bot + " " + startPath};
+    check.seed = options.seed + static_cast<uint64_t>(tuner.iterations + 1) * options.games;
+    TournamentStats stats = playTournament(check, playMatch, true);
+    printf("Tuned against starting values: %.1f%% +- %.1f%% over %ld games\n", stats.score() * 100,
+           stats.margin() * 100, stats.games);
+
+    for (const string &path : {startPath, plusPath, minusPath, tunedPath})
+        unlink(path.c_str());
+    rmdir(directory);
+
+    if (stats.score() <= 0.5) {
+        printf("No improvement, %s left as it was\n", tuner.output.c_str());
+        return 0;
+    }
+    char provenance[256];
+    snprintf(provenance, sizeof(provenance),
+             "// Generated by `make tune`: SPSA over %d iterations of %d self-play games, then %.1f%% +- %.1f%%\n"
+             "// against the values it started from in %ld games.",
+             tuner.iterations, options.games, stats.score() * 100, stats.margin() * 100, stats.games);
+    if (!writeTunedHeader(tuner.output, parameters, tuned, provenance)) {
+        perror(tuner.output.c_str());
+        return 1;
+    }
+    printf("Wrote %s\n", tuner.output.c_str());
+    return 0;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <chrono>
+
+using namespace std;
+
+// Time left in the current turn, counted from the moment its input arrived. The first turn gets its own, longer
+// budget. Search loops poll shouldStop() and hand back the best answer they have once it returns true; anything
+// that can't be interrupted checks timeLeft() up front and falls back to a cheaper heuristic.
+class TurnBudget {
+public:
+    static TurnBudget& get() {
+        static TurnBudget turnBudget;
+        return turnBudget;
+    }
+
+    // Codingame allows 1000ms for the first turn and 50ms for the others. The bots budget a tenth less, the margin
+    // covering I/O and scheduling.
+    static constexpr long FIRST_TURN_LIMIT_MICROSECONDS = 1000000;
+    static constexpr long TURN_LIMIT_MICROSECONDS = 50000;
+    static constexpr long FIRST_TURN_BUDGET_MICROSECONDS = FIRST_TURN_LIMIT_MICROSECONDS * 9 / 10;
+    static constexpr long TURN_BUDGET_MICROSECONDS = TURN_LIMIT_MICROSECONDS * 9 / 10;
+
+    void configure(long firstTurnMicroseconds = FIRST_TURN_BUDGET_MICROSECONDS,
+                   long turnMicroseconds = TURN_BUDGET_MICROSECONDS) {
+        firstTurnBudget = chrono::microseconds(firstTurnMicroseconds);
+        turnBudget = chrono::microseconds(turnMicroseconds);
+    }
+
+    // Call as soon as the turn's first input byte is available.
+    void startTurn() {
+        deadline = chrono::steady_clock::now() + (turn == 0 ? firstTurnBudget : turnBudget);
+        turn++;
+    }
+
+    long timeLeft() const {
+        return chrono::duration_cast<chrono::microseconds>(deadline - chrono::steady_clock::now()).count();
+    }
+
+    bool shouldStop() const {
+        return chrono::steady_clock::now() >= deadline;
+    }
+
+private:
+    chrono::microseconds firstTurnBudget{FIRST_TURN_BUDGET_MICROSECONDS};
+    chrono::microseconds turnBudget{TURN_BUDGET_MICROSECONDS};
+    chrono::steady_clock::time_point deadline = chrono::steady_clock::time_point::max();
+    int turn = 0;
+};
@@ -0,0 +1,3 @@
+#include "actions.hpp"
+
+ActionStringArray actionToString{"MOVE", "BUILD", "SPAWN", "WAIT", "MESSAGE"};
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "config.hpp"
+#include "board.hpp"
+
+enum class ACTION {
+    MOVE,
+    BUILD,
+    SPAWN,
+    WAIT,
+    MESSAGE,
+    Count
+};
+using ActionStringArray = array<char[8], static_cast<size_t>(ACTION::Count)>;
+extern ActionStringArray actionToString;
+
+struct Action {
+    static Action move(int amount, Coord pos, Coord target) { return Action{ACTION::MOVE, amount, pos, target}; }
+    static Action build(Coord pos) { return Action{ACTION::BUILD, 0, pos}; }
+    static Action spawn(int amount, Coord pos) { return Action{ACTION::SPAWN, amount, pos}; }
+    static Action wait() { return Action{ACTION::WAIT}; }
+
+    ACTION kind;
+    int amount;
+    Coord pos;
+    Coord target;
+};
+using Actions = vector<Action>;
@@ -0,0 +1,151 @@
+#include "../../common/bench.hpp"
+#include "../../common/random.hpp"
+#include "../actions.hpp"
+#include "../bitboard.hpp"
+#include "../board.hpp"
+#include "../config.hpp"
+#include "../dispatch.hpp"
+#include "../recyclerYield.hpp"
+#include "../regions.hpp"
+#include "../simulator.hpp"
+#include "../tileEvaluation.hpp"
+
+// Defined in main.cpp, which the bench build compiles without its main().
+extern Board board;
+extern Actions nextActions;
+void init(InputReader& in);
+void updateGameStatus(InputReader& in);
+void moveByRandomWalk(int tile, int units);
+WeightedSampler<DIRECTION_COUNT> getWeigthedNeighbors(int tile, const TileNeighbors& neighbors);
+
+namespace {
+    string turnInput;
+    vector<int> ownUnitTiles;
+
+    // Parses the fixture once so every benchmark starts from the same board.
+    void setUp() {
+        static bool done = false;
+        if (done) return;
+        done = true;
+
+        turnInput = loadFixture("bench/fixture.log");
+        InputReader initInput(takeLines(turnInput, 1));
+        init(initInput);
+        InputReader in(turnInput);
+        updateGameStatus(in);
+        for (int tile = 0; tile < geometry.tileCount; tile++) {
+            if (board.owner[tile] == OWN_PLAYER && board.units[tile] > 0) ownUnitTiles.push_back(tile);
+        }
+    }
+}
+
+BENCHMARK(updateGameStatus) {
+    setUp();
+    for (long i = 0; i < iterations; i++) {
+        InputReader in(turnInput);
+        updateGameStatus(in);
+    }
+}
+
+// getBestTileForRecycler became a pick over the yields of the tile evaluation.
+BENCHMARK(recyclerYieldSelect) {
+    setUp();
+    int tiles[MAX_TILES];
+    for (long i = 0; i < iterations; i++) {
+        doNotOptimize(selectRecyclerTiles(tileEvaluation, bitboards.canBuild, 3, tiles));
+    }
+}
+
+BENCHMARK(evaluateTiles) {
+    setUp();
+    TileEvaluation evaluation;
+    for (long i = 0; i < iterations; i++) {
+        tileEvaluator.evaluate(board, evaluation);
+        doNotOptimize(evaluation);
+    }
+}
+
+BENCHMARK(evaluateTilesScalar) {
+    setUp();
+    TileEvaluator scalar = tileEvaluator;
+    scalar.vectorized = false;
+    TileEvaluation evaluation;
+    for (long i = 0; i < iterations; i++) {
+        scalar.evaluate(board, evaluation);
+        doNotOptimize(evaluation);
+    }
+}
+
+BENCHMARK(evaluateBalances) {
+    setUp();
+    TileEvaluation evaluation;
+    for (long i = 0; i < iterations; i++) {
+        tileEvaluator.evaluateBalances(board, evaluation);
+        doNotOptimize(evaluation);
+    }
+}
+
+BENCHMARK(getWeigthedNeighbors) {
+    setUp();
+    for (long i = 0; i < iterations; i++) {
+        int tile = ownUnitTiles[i % ownUnitTiles.size()];
+        doNotOptimize(getWeigthedNeighbors(tile, board.passableNeighbors(tile)));
+    }
+}
+
+BENCHMARK(moveByRandomWalk) {
+    setUp();
+    for (long i = 0; i < iterations; i++) {
+        nextActions.clear();
+        int tile = ownUnitTiles[i % ownUnitTiles.size()];
+        moveByRandomWalk(tile, board.units[tile]);
+    }
+    doNotOptimize(nextActions);
+}
+
+BENCHMARK(robotDispatch) {
+    setUp();
+    for (long i = 0; i < iterations; i++) {
+        nextActions.clear();
+        robotDispatch.dispatch(board, bitboards.own & bitboards.units & regions.contested,
+                               regions.contested.andNot(bitboards.own), nextActions);
+    }
+    doNotOptimize(nextActions);
+}
+
+BENCHMARK(floodFill) {
+    setUp();
+    Bitboard walkable = bitboards.walkable();
+    for (long i = 0; i < iterations; i++) {
+        doNotOptimize(floodFill(Bitboard::single(ownUnitTiles[i % ownUnitTiles.size()]), walkable));
+    }
+}
+
+// Paths from every robot to the opposite corner of the map, the long moves dispatch hands to the simulator.
+BENCHMARK(getNextStepTile) {
+    setUp();
+    for (long i = 0; i < iterations; i++) {
+        int from = ownUnitTiles[i % ownUnitTiles.size()];
+        doNotOptimize(getNextStepTile(board, from, geometry.tileCount - 1 - from));
+    }
+}
+
+BENCHMARK(simulateTurn) {
+    setUp();
+    SimState root{board, {}, 0};
+    root.matter.fill(20);
+    Actions ownActions;
+    for (int tile : ownUnitTiles) {
+        ownActions.push_back(Action::move(1, geometry.coord(tile), geometry.coord(geometry.tileCount - 1 - tile)));
+    }
+    Actions opponentActions;
+    for (long i = 0; i < iterations; i++) {
+        SimState state = root;
+        simulateTurn(state, ownActions, opponentActions);
+        doNotOptimize(state);
+    }
+}
+
+int main(int argc, char** argv) {
+    return runBenchmarks(argc, argv);
+}
@@ -0,0 +1,48 @@
+#include "bitboard.hpp"
+#include "boardKernels.hpp"
+
+BitboardGeometry bitboardGeometry;
+Bitboards bitboards;
+
+void BitboardGeometry::resize() {
+    all = Bitboard{0};
+    notFirstColumn = Bitboard{0};
+    notLastColumn = Bitboard{0};
+    for (int tile = 0; tile < geometry.tileCount; tile++) {
+        all.set(tile);
+        if (geometry.tileX[tile] != 0) notFirstColumn.set(tile);
+        if (geometry.tileX[tile] != geometry.width - 1) notLastColumn.set(tile);
+    }
+}
+
+Bitboard floodFill(Bitboard seed, Bitboard area) {
+    return boardKernels.floodFill(seed, area);
+}
+
+int countRegions(Bitboard area) {
+    int regions = 0;
+    while (!area.empty()) {
+        area = area.andNot(floodFill(Bitboard::single(area.first()), area));
+        regions++;
+    }
+    return regions;
+}
+
+Bitboard frontier(Bitboard area, Bitboard outside) {
+    return area & adjacent(outside);
+}
+
+void Bitboards::update(const Board &board) {
+    *this = Bitboards{};
+    for (int tile = 0; tile < geometry.tileCount; tile++) {
+        Bitboard bit = Bitboard::single(tile);
+        if (board.owner[tile] == OWN_PLAYER) own |= bit;
+        else if (board.owner[tile] == OPPONENT_PLAYER) opponent |= bit;
+        if (board.scrapAmount[tile] == 0) grass |= bit;
+        if (board.recycler[tile]) recycler |= bit;
+        if (board.units[tile] > 0) units |= bit;
+        if (board.canBuild[tile]) canBuild |= bit;
+        if (board.canSpawn[tile]) canSpawn |= bit;
+        if (board.willBeScrapped[tile]) willBeScrapped |= bit;
+    }
+}
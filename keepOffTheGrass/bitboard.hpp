@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+
+#include "config.hpp"
+#include "board.hpp"
+
+static_assert(MAX_TILES <= 128, "A bitboard holds the whole map in two 64 bit words");
+
+// One bit per tile, using the row-major tile index of BoardGeometry.
+struct Bitboard {
+    using Word = unsigned __int128;
+
+    static Bitboard single(int tile) { return Bitboard{Word(1) << tile}; }
+
+    bool test(int tile) const { return (bits >> tile) & 1; }
+    void set(int tile) { bits |= Word(1) << tile; }
+    void reset(int tile) { bits &= ~(Word(1) << tile); }
+    bool empty() const { return bits == 0; }
+    int count() const { return __builtin_popcountll(uint64_t(bits)) + __builtin_popcountll(uint64_t(bits >> 64)); }
+    // Index of the lowest set tile, the bitboard must not be empty.
+    int first() const {
+        uint64_t low = bits;
+        return low ? __builtin_ctzll(low) : 64 + __builtin_ctzll(uint64_t(bits >> 64));
+    }
+
+    Bitboard operator&(Bitboard other) const { return Bitboard{bits & other.bits}; }
+    Bitboard operator|(Bitboard other) const { return Bitboard{bits | other.bits}; }
+    Bitboard operator^(Bitboard other) const { return Bitboard{bits ^ other.bits}; }
+    Bitboard andNot(Bitboard other) const { return Bitboard{bits & ~other.bits}; }
+    Bitboard &operator&=(Bitboard other) { bits &= other.bits; return *this; }
+    Bitboard &operator|=(Bitboard other) { bits |= other.bits; return *this; }
+    bool operator==(Bitboard other) const { return bits == other.bits; }
+    bool operator!=(Bitboard other) const { return bits != other.bits; }
+
+    Word bits;
+};
+
+// Map shaped masks, computed once in init() next to the BoardGeometry.
+struct BitboardGeometry {
+    void resize();
+
+    Bitboard all;
+    // Tiles that may receive a bit shifted from their left or right neighbor without wrapping rows.
+    Bitboard notFirstColumn;
+    Bitboard notLastColumn;
+};
+
+extern BitboardGeometry bitboardGeometry;
+
+// Every tile that is orthogonally adjacent to a tile of the bitboard.
+inline Bitboard adjacent(Bitboard tiles) {
+    Bitboard::Word bits = tiles.bits;
+    Bitboard::Word spread = ((bits << 1) & bitboardGeometry.notFirstColumn.bits) |
+                            ((bits >> 1) & bitboardGeometry.notLastColumn.bits) | (bits << geometry.width) |
+                            (bits >> geometry.width);
+    return Bitboard{spread & bitboardGeometry.all.bits};
+}
+
+// All tiles of area connected to seed through orthogonal steps inside area.
+Bitboard floodFill(Bitboard seed, Bitboard area);
+int countRegions(Bitboard area);
+// Tiles of area touching at least one tile of outside.
+Bitboard frontier(Bitboard area, Bitboard outside);
+
+// Bitboard view of a Board, filled alongside it in updateGameStatus().
+struct Bitboards {
+    void update(const Board &board);
+    Bitboard walkable() const { return bitboardGeometry.all.andNot(grass | recycler); }
+
+    Bitboard own;
+    Bitboard opponent;
+    Bitboard grass;
+    Bitboard recycler;
+    Bitboard units;
+    Bitboard canBuild;
+    Bitboard canSpawn;
+    Bitboard willBeScrapped;
+};
+
+extern Bitboards bitboards;
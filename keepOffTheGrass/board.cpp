@@ -0,0 +1,40 @@
+#include <cassert>
+
+#include "board.hpp"
+
+BoardGeometry geometry;
+
+void BoardGeometry::resize(int boardWidth, int boardHeight) {
+    assert(boardWidth <= MAX_WIDTH && boardHeight <= MAX_HEIGHT);
+    width = boardWidth;
+    height = boardHeight;
+    tileCount = width * height;
+
+    for (int tile = 0; tile < tileCount; tile++) {
+        int tx = tile % width;
+        int ty = tile / width;
+        tileX[tile] = tx;
+        tileY[tile] = ty;
+
+        auto& tileStep = step[tile];
+        tileStep[static_cast<int>(DIRECTION::UP)] = ty > 0 ? tile - width : NO_TILE;
+        tileStep[static_cast<int>(DIRECTION::DOWN)] = ty < height - 1 ? tile + width : NO_TILE;
+        tileStep[static_cast<int>(DIRECTION::LEFT)] = tx > 0 ? tile - 1 : NO_TILE;
+        tileStep[static_cast<int>(DIRECTION::RIGHT)] = tx < width - 1 ? tile + 1 : NO_TILE;
+
+        neighborCount[tile] = 0;
+        for (int neighbor : tileStep) {
+            if (neighbor != NO_TILE) neighbors[tile][neighborCount[tile]++] = neighbor;
+        }
+    }
+}
+
+TileNeighbors Board::passableNeighbors(int tile) const {
+    TileNeighbors result;
+    result.count = 0;
+    for (int i = 0; i < geometry.neighborCount[tile]; i++) {
+        int neighbor = geometry.neighbors[tile][i];
+        if (isPassable(neighbor)) result.tiles[result.count++] = neighbor;
+    }
+    return result;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <tuple>
+
+#include "config.hpp"
+
+using Coord = tuple<int, int>;
+inline int x(Coord coord) { return get<0>(coord); }
+inline int y(Coord coord) { return get<1>(coord); }
+inline Coord coord(int x, int y) { return make_tuple(x, y); }
+
+enum class DIRECTION {
+    UP, DOWN, LEFT, RIGHT, Count
+};
+constexpr int DIRECTION_COUNT = static_cast<int>(DIRECTION::Count);
+const int NO_TILE = -1;
+
+// Values of Board::owner, also used to index per player arrays.
+const int OWN_PLAYER = 1;
+const int OPPONENT_PLAYER = 0;
+const int NO_OWNER = -1;
+const int PLAYER_COUNT = 2;
+
+using TileArray = array<int16_t, MAX_TILES>;
+
+struct TileNeighbors {
+    array<int8_t, DIRECTION_COUNT> tiles;
+    int count;
+};
+
+// Map shape, computed once in init(). Tiles are indexed row-major (y * width + x) so the whole board is a
+// single linear range [0, tileCount).
+struct BoardGeometry {
+    void resize(int boardWidth, int boardHeight);
+    int index(int x, int y) const { return y * width + x; }
+    int index(Coord coord) const { return index(::x(coord), ::y(coord)); }
+    Coord coord(int tile) const { return ::coord(tileX[tile], tileY[tile]); }
+    int neighbor(int tile, DIRECTION direction) const { return step[tile][static_cast<int>(direction)]; }
+
+    int width;
+    int height;
+    int tileCount;
+    array<int8_t, MAX_TILES> tileX;
+    array<int8_t, MAX_TILES> tileY;
+    // Neighbor by direction, NO_TILE when it falls outside the map.
+    array<array<int8_t, DIRECTION_COUNT>, MAX_TILES> step;
+    // In-map neighbors packed at the front, neighborCount of them.
+    array<array<int8_t, DIRECTION_COUNT>, MAX_TILES> neighbors;
+    array<int8_t, MAX_TILES> neighborCount;
+};
+
+extern BoardGeometry geometry;
+
+// Per-turn tile state as a struct of arrays. Plain data, so copying a board is a single memcpy.
+struct Board {
+    bool isPassable(int tile) const { return recycler[tile] == 0; }
+    TileNeighbors passableNeighbors(int tile) const;
+
+    TileArray scrapAmount;
+    TileArray owner;
+    TileArray units;
+    TileArray recycler;
+    TileArray canBuild;
+    TileArray canSpawn;
+    TileArray willBeScrapped;
+};
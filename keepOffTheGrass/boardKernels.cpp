@@ -0,0 +1,144 @@
+#include "boardKernels.hpp"
+
+namespace {
+    using Word = Bitboard::Word;
+
+    // A map size known at compile time.
+    template <int WIDTH, int HEIGHT> struct FixedShape {
+        static_assert(WIDTH <= MAX_WIDTH && HEIGHT <= MAX_HEIGHT, "The board arrays can't hold this map");
+
+        static constexpr Word mask(int skippedColumn) {
+            Word bits = 0;
+            for (int tile = 0; tile < WIDTH * HEIGHT; tile++) {
+                if (tile % WIDTH != skippedColumn) bits |= Word(1) << tile;
+            }
+            return bits;
+        }
+        static constexpr Word ALL = mask(-1);
+        static constexpr Word NOT_FIRST_COLUMN = mask(0);
+        static constexpr Word NOT_LAST_COLUMN = mask(WIDTH - 1);
+
+        static constexpr int width() { return WIDTH; }
+        static constexpr int tileCount() { return WIDTH * HEIGHT; }
+        static constexpr Word all() { return ALL; }
+        static constexpr Word notFirstColumn() { return NOT_FIRST_COLUMN; }
+        static constexpr Word notLastColumn() { return NOT_LAST_COLUMN; }
+
+        // Same UP, DOWN, LEFT, RIGHT order as BoardGeometry::neighbors.
+        template <typename Visit> static void forEachNeighbor(int tile, Visit visit) {
+            int x = tile % WIDTH;
+            int y = tile / WIDTH;
+            if (y > 0) visit(tile - WIDTH);
+            if (y < HEIGHT - 1) visit(tile + WIDTH);
+            if (x > 0) visit(tile - 1);
+            if (x < WIDTH - 1) visit(tile + 1);
+        }
+    };
+
+    // Whatever size init() read.
+    struct RuntimeShape {
+        static int width() { return geometry.width; }
+        static int tileCount() { return geometry.tileCount; }
+        static Word all() { return bitboardGeometry.all.bits; }
+        static Word notFirstColumn() { return bitboardGeometry.notFirstColumn.bits; }
+        static Word notLastColumn() { return bitboardGeometry.notLastColumn.bits; }
+
+        template <typename Visit> static void forEachNeighbor(int tile, Visit visit) {
+            for (int i = 0; i < geometry.neighborCount[tile]; i++) {
+                visit(geometry.neighbors[tile][i]);
+            }
+        }
+    };
+
+    template <typename Shape> Word spread(Word bits) {
+        Word spread = ((bits << 1) & Shape::notFirstColumn()) | ((bits >> 1) & Shape::notLastColumn()) |
+                      (bits << Shape::width()) | (bits >> Shape::width());
+        return spread & Shape::all();
+    }
+
+    template <typename Shape> Bitboard floodFill(Bitboard seed, Bitboard area) {
+        Word filled = seed.bits & area.bits;
+        while (true) {
+            Word next = filled | (spread<Shape>(filled) & area.bits);
+            if (next == filled) return Bitboard{filled};
+            filled = next;
+        }
+    }
+
+    bool isWalkable(const Board &board, int tile) {
+        return board.scrapAmount[tile] > 0 && board.recycler[tile] == 0;
+    }
+
+    // Grows the walkable tiles at distance 1, 2, ... of target one bitboard layer at a time. The first layer that
+    // reaches a neighbor of from holds the closest ones, and ties go to the first of them in neighbor order like the
+    // tile by tile BFS did.
+    template <typename Shape> int nextStepTile(const Board &board, int from, int target) {
+        Word fromNeighbors = spread<Shape>(Word(1) << from);
+        if (!isWalkable(board, target)) return NO_TILE;
+        if ((fromNeighbors >> target) & 1) return target;
+
+        Word walkable = 0;
+        for (int tile = 0; tile < Shape::tileCount(); tile++) {
+            if (isWalkable(board, tile)) walkable |= Word(1) << tile;
+        }
+
+        Word reached = Word(1) << target;
+        Word layer = reached;
+        while (layer) {
+            layer = spread<Shape>(layer) & walkable & ~reached;
+            reached |= layer;
+            Word closest = layer & fromNeighbors;
+            if (!closest) continue;
+
+            int bestTile = NO_TILE;
+            Shape::forEachNeighbor(from, [&](int neighbor) {
+                if (bestTile == NO_TILE && ((closest >> neighbor) & 1)) bestTile = neighbor;
+            });
+            return bestTile;
+        }
+        return NO_TILE;
+    }
+
+    template <typename Shape> void refreshDerivedFlags(Board &board) {
+        for (int tile = 0; tile < Shape::tileCount(); tile++) {
+            bool alive = board.scrapAmount[tile] > 0;
+            bool owned = board.owner[tile] == OWN_PLAYER;
+            board.canSpawn[tile] = owned && alive && !board.recycler[tile];
+            board.canBuild[tile] = board.canSpawn[tile] && board.units[tile] == 0;
+
+            bool nearRecycler = board.recycler[tile];
+            Shape::forEachNeighbor(tile, [&](int neighbor) { nearRecycler |= board.recycler[neighbor] != 0; });
+            board.willBeScrapped[tile] = alive && nearRecycler && board.scrapAmount[tile] == 1;
+        }
+    }
+
+    template <typename Shape> constexpr BoardKernels makeKernels() {
+        return BoardKernels{floodFill<Shape>, nextStepTile<Shape>, refreshDerivedFlags<Shape>};
+    }
+
+    struct SizedKernels {
+        int width;
+        int height;
+        BoardKernels kernels;
+    };
+
+    // The real maps are about twice as wide as high, these are the ones that fit MAX_WIDTH x MAX_HEIGHT.
+    const SizedKernels SIZED_KERNELS[] = {
+        {12, 6, makeKernels<FixedShape<12, 6>>()}, {13, 6, makeKernels<FixedShape<13, 6>>()},
+        {14, 6, makeKernels<FixedShape<14, 6>>()}, {15, 6, makeKernels<FixedShape<15, 6>>()},
+        {12, 7, makeKernels<FixedShape<12, 7>>()}, {13, 7, makeKernels<FixedShape<13, 7>>()},
+        {14, 7, makeKernels<FixedShape<14, 7>>()}, {15, 7, makeKernels<FixedShape<15, 7>>()},
+    };
+}
+
+BoardKernels boardKernels = makeKernels<RuntimeShape>();
+
+bool selectBoardKernels(int width, int height) {
+    for (const SizedKernels &sized : SIZED_KERNELS) {
+        if (sized.width != width || sized.height != height) continue;
+        boardKernels = sized.kernels;
+        return true;
+    }
+    boardKernels = makeKernels<RuntimeShape>();
+    return false;
+}
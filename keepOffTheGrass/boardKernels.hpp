@@ -0,0 +1,19 @@
+#pragma once
+
+#include "config.hpp"
+#include "board.hpp"
+#include "bitboard.hpp"
+
+// The per-tile kernels of the simulator and the region analysis, compiled once per common map size so that tile
+// counts, neighbor offsets and row masks are constants the compiler can unroll and fold. init() picks the
+// instantiation for the map it read, other sizes run the same code on the runtime BoardGeometry.
+struct BoardKernels {
+    Bitboard (*floodFill)(Bitboard seed, Bitboard area);
+    int (*nextStepTile)(const Board &board, int from, int target);
+    void (*refreshDerivedFlags)(Board &board);
+};
+
+extern BoardKernels boardKernels;
+
+// Call after geometry and bitboardGeometry are resized. Returns whether the size has its own instantiation.
+bool selectBoardKernels(int width, int height);
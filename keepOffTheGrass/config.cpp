@@ -0,0 +1,11 @@
+#include "config.hpp"
+
+#ifdef TUNABLE
+namespace Settings {
+    TUNED_PARAMETERS(DEFINE_PARAMETER)
+
+    void loadParameters(const char *path) {
+        readParameters(path, {TUNED_PARAMETERS(PARAMETER_BINDING)});
+    }
+}
+#endif
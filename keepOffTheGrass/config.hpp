@@ -0,0 +1,52 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+
+#include "../common/parameters.hpp"
+#include "../common/profiler.hpp"
+#include "tunedParameters.hpp"
+
+using namespace std;
+
+// Weights searched by `make tune`, see parameters.hpp: random walk weights of neighbor tiles by owner, recycler
+// scrap weights by owner of the harvested tile, and owned tiles per recycler.
+#define TUNED_PARAMETERS(PARAMETER)                                                                 \
+    PARAMETER(int, freeTileWeight, Tuned::freeTileWeight, 1, 64)                                    \
+    PARAMETER(int, opponentTileWeight, Tuned::opponentTileWeight, 1, 64)                            \
+    PARAMETER(int, ownTileWeight, Tuned::ownTileWeight, 1, 64)                                      \
+    PARAMETER(float, freeTileScrapWeight, Tuned::freeTileScrapWeight, -4, 4)                        \
+    PARAMETER(float, opponentTileScrapWeight, Tuned::opponentTileScrapWeight, -4, 4)                \
+    PARAMETER(float, ownTileScrapWeight, Tuned::ownTileScrapWeight, -4, 4)                          \
+    PARAMETER(int, tilesPerTower, Tuned::tilesPerTower, 5, 60)
+
+namespace Settings {
+    TUNED_PARAMETERS(DECLARE_PARAMETER)
+#ifdef TUNABLE
+    void loadParameters(const char *path);
+#endif
+
+    // Applied on top of the owner weight when a neighbor is closer to the nearest neutral or opponent tile.
+    const int closerNeighborWeightFactor = 2;
+
+    const int rolloutCandidates = 8;
+    const int rolloutDepth = 6;
+    const int rolloutBudgetMicroseconds = 35000;
+    const int rolloutsPerTask = 2;
+#ifdef OFFLINE_EVAL
+    // Offline self-play spreads rollouts over the workers `make offline-tournament` asks for.
+    const int rolloutThreads = OFFLINE_EVAL;
+#else
+    const int rolloutThreads = 1;
+#endif
+    const float rolloutUnitWeight = 0.5;
+    const float rolloutMatterWeight = 0.05;
+}
+
+
+const int MAX_WIDTH = 15;
+const int MAX_HEIGHT = 7;
+constexpr int MAX_TILES = MAX_WIDTH * MAX_HEIGHT;
+const int MAX_ACTIONS = 100;
+const int BUILD_COST = 10;
+const int BASE_MATTER_INCOME = 10;
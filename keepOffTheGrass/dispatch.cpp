@@ -0,0 +1,119 @@
+#include <algorithm>
+#include <climits>
+
+#include "dispatch.hpp"
+
+RobotDispatch robotDispatch;
+
+int RobotDispatch::dispatch(const Board &board, Bitboard unitTiles, Bitboard targets, Actions &actions) {
+    PROFILE_ZONE("dispatch");
+    int targetCount = 0;
+    for (; !targets.empty(); targets.reset(targets.first())) {
+        columnTile[targetCount++] = targets.first();
+    }
+
+    int rows = 0;
+    unplanned = Bitboard{0};
+    for (; !unitTiles.empty(); unitTiles.reset(unitTiles.first())) {
+        int tile = unitTiles.first();
+        int planned = min<int>(board.units[tile], MAX_UNITS - rows);
+        if (planned < board.units[tile]) {
+            unplanned.set(tile);
+            unplannedCounts[tile] = board.units[tile] - planned;
+        }
+        if (planned == 0) continue;
+
+        computeDistances(board, tile);
+        for (int unit = 0; unit < planned; unit++) {
+            unitTile[rows++] = tile;
+            for (int target = 0; target < targetCount; target++) {
+                int steps = distance[columnTile[target]];
+                cost[rows][target + 1] = steps >= 0 ? steps : UNREACHABLE_COST;
+            }
+        }
+    }
+    if (rows == 0 || targetCount == 0) return 0;
+
+    // One idle column per unit keeps the problem rectangular with at least as many columns as rows.
+    int columns = targetCount + rows;
+    for (int row = 1; row <= rows; row++) {
+        fill(cost[row].begin() + targetCount + 1, cost[row].begin() + columns + 1, IDLE_COST);
+    }
+    solve(rows, columns);
+
+    // Each target takes at most one unit, so every assignment is its own single unit move.
+    int assigned = 0;
+    for (int column = 1; column <= targetCount; column++) {
+        int row = columnRow[column];
+        if (row == 0 || cost[row][column] == UNREACHABLE_COST) continue;
+        actions.push_back(Action::move(1, geometry.coord(unitTile[row - 1]), geometry.coord(columnTile[column - 1])));
+        assigned++;
+    }
+    return assigned;
+}
+
+// Walking distance from 'from' to every tile, -1 when out of reach.
+void RobotDispatch::computeDistances(const Board &board, int from) {
+    fill_n(distance.begin(), geometry.tileCount, -1);
+    int head = 0;
+    int tail = 0;
+    distance[from] = 0;
+    queue[tail++] = from;
+    while (head < tail) {
+        int tile = queue[head++];
+        for (int i = 0; i < geometry.neighborCount[tile]; i++) {
+            int neighbor = geometry.neighbors[tile][i];
+            if (distance[neighbor] >= 0 || board.scrapAmount[neighbor] == 0 || board.recycler[neighbor]) continue;
+            distance[neighbor] = distance[tile] + 1;
+            queue[tail++] = neighbor;
+        }
+    }
+}
+
+// Shortest augmenting path Hungarian algorithm, O(rows^2 * columns). Leaves the row matched to each column in
+// columnRow, 0 for unmatched columns.
+void RobotDispatch::solve(int rows, int columns) {
+    fill_n(rowPotential.begin(), rows + 1, 0);
+    fill_n(columnPotential.begin(), columns + 1, 0);
+    fill_n(columnRow.begin(), columns + 1, 0);
+
+    for (int row = 1; row <= rows; row++) {
+        columnRow[0] = row;
+        int currentColumn = 0;
+        fill_n(minSlack.begin(), columns + 1, INT_MAX);
+        fill_n(used.begin(), columns + 1, false);
+        do {
+            used[currentColumn] = true;
+            int currentRow = columnRow[currentColumn];
+            int delta = INT_MAX;
+            int nextColumn = 0;
+            for (int column = 1; column <= columns; column++) {
+                if (used[column]) continue;
+                int slack = cost[currentRow][column] - rowPotential[currentRow] - columnPotential[column];
+                if (slack < minSlack[column]) {
+                    minSlack[column] = slack;
+                    way[column] = currentColumn;
+                }
+                if (minSlack[column] < delta) {
+                    delta = minSlack[column];
+                    nextColumn = column;
+                }
+            }
+            for (int column = 0; column <= columns; column++) {
+                if (used[column]) {
+                    rowPotential[columnRow[column]] += delta;
+                    columnPotential[column] -= delta;
+                } else {
+                    minSlack[column] -= delta;
+                }
+            }
+            currentColumn = nextColumn;
+        } while (columnRow[currentColumn] != 0);
+
+        do {
+            int previousColumn = way[currentColumn];
+            columnRow[currentColumn] = columnRow[previousColumn];
+            currentColumn = previousColumn;
+        } while (currentColumn != 0);
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "config.hpp"
+#include "board.hpp"
+#include "bitboard.hpp"
+#include "actions.hpp"
+
+// Sends every unit to its own target tile so stacks don't pile onto the same tile while others stay uncovered.
+// Units and targets are matched by minimum total walking distance (Hungarian algorithm over BFS distances). Units
+// left without a reachable target stay where they are. All buffers live in the object, a call never allocates.
+class RobotDispatch {
+public:
+    static constexpr int MAX_UNITS = 64;
+
+    // Appends the moves for the units standing on unitTiles. Returns how many units got a target.
+    int dispatch(const Board &board, Bitboard unitTiles, Bitboard targets, Actions &actions);
+    // Units the last dispatch() left out once it had MAX_UNITS rows, for the caller to move some other way.
+    Bitboard unplannedTiles() const { return unplanned; }
+    int unplannedUnits(int tile) const { return unplannedCounts[tile]; }
+
+private:
+    static constexpr int MAX_COLUMNS = MAX_TILES + MAX_UNITS;
+    static constexpr int IDLE_COST = 1000;
+    static constexpr int UNREACHABLE_COST = 100000;
+
+    void computeDistances(const Board &board, int from);
+    void solve(int rows, int columns);
+
+    array<int8_t, MAX_TILES> distance;
+    array<int8_t, MAX_TILES> queue;
+    array<int8_t, MAX_UNITS> unitTile;
+    array<int8_t, MAX_COLUMNS> columnTile;
+    // 1-indexed like the classic formulation, row and column 0 are the virtual start.
+    array<array<int, MAX_COLUMNS + 1>, MAX_UNITS + 1> cost;
+    array<int, MAX_UNITS + 1> rowPotential;
+    array<int, MAX_COLUMNS + 1> columnPotential;
+    array<int, MAX_COLUMNS + 1> columnRow;
+    array<int, MAX_COLUMNS + 1> way;
+    array<int, MAX_COLUMNS + 1> minSlack;
+    array<bool, MAX_COLUMNS + 1> used;
+    Bitboard unplanned;
+    TileArray unplannedCounts;
+};
+
+extern RobotDispatch robotDispatch;
@@ -0,0 +1,143 @@
+#include <algorithm>
+
+#include "distanceField.hpp"
+
+DistanceFields distances;
+
+void DistanceField::update(const TileMask &newSources, const TileMask &newWalkable) {
+    if (!initialized) {
+        sources = newSources;
+        walkable = newWalkable;
+        rebuild();
+        initialized = true;
+        return;
+    }
+
+    fill_n(invalid.begin(), geometry.tileCount, false);
+    fill_n(seeded.begin(), geometry.tileCount, false);
+    for (int tile = 0; tile < geometry.tileCount; tile++) {
+        bool lostSource = sources[tile] && !newSources[tile];
+        bool lostWalkable = walkable[tile] && !newWalkable[tile];
+        seeded[tile] = (!sources[tile] && newSources[tile]) || (!walkable[tile] && newWalkable[tile]);
+        sources[tile] = newSources[tile];
+        walkable[tile] = newWalkable[tile];
+        if (lostSource || lostWalkable) invalidate(tile);
+    }
+
+    // New sources, newly walkable tiles and invalidated tiles restart from their best valid neighbor.
+    int seedCount = 0;
+    for (int tile = 0; tile < geometry.tileCount; tile++) {
+        if (!walkable[tile] || !(seeded[tile] || invalid[tile])) continue;
+        int best = sources[tile] ? 0 : UNREACHABLE;
+        for (int n = 0; n < geometry.neighborCount[tile] && best > 0; n++) {
+            int neighbor = geometry.neighbors[tile][n];
+            if (distance[neighbor] != UNREACHABLE) best = min(best, distance[neighbor] + 1);
+        }
+        distance[tile] = min<int>(distance[tile], best);
+        seeds[seedCount++] = tile;
+    }
+    relax(seedCount);
+}
+
+void DistanceField::rebuild() {
+    int seedCount = 0;
+    for (int tile = 0; tile < geometry.tileCount; tile++) {
+        distance[tile] = sources[tile] && walkable[tile] ? 0 : UNREACHABLE;
+        if (distance[tile] == 0) seeds[seedCount++] = tile;
+    }
+    relax(seedCount);
+}
+
+// Drops the tile's distance and, recursively, the distance of every neighbor that no longer has a valid neighbor
+// one step closer to a source.
+void DistanceField::invalidate(int tile) {
+    if (invalid[tile]) return;
+
+    int head = 0;
+    int tail = 0;
+    auto push = [&](int queuedTile) {
+        invalid[queuedTile] = true;
+        queuedDistances[tail] = distance[queuedTile];
+        queue[tail++] = queuedTile;
+        distance[queuedTile] = UNREACHABLE;
+    };
+
+    push(tile);
+    while (head < tail) {
+        int oldDistance = queuedDistances[head];
+        int current = queue[head++];
+        if (oldDistance == UNREACHABLE) continue;
+
+        for (int n = 0; n < geometry.neighborCount[current]; n++) {
+            int neighbor = geometry.neighbors[current][n];
+            if (invalid[neighbor] || sources[neighbor] || distance[neighbor] != oldDistance + 1) continue;
+
+            bool supported = false;
+            for (int s = 0; s < geometry.neighborCount[neighbor] && !supported; s++) {
+                supported = distance[geometry.neighbors[neighbor][s]] == oldDistance;
+            }
+            if (!supported) push(neighbor);
+        }
+    }
+}
+
+// Breadth first relaxation from seeds that may start at different distances. Seeds are merged into the queue in
+// distance order, so tiles are settled in nondecreasing distance and each one by the first improvement it receives.
+void DistanceField::relax(int seedCount) {
+    for (int i = 0; i < seedCount; i++) {
+        seedDistances[i] = distance[seeds[i]];
+    }
+    sort(seeds.begin(), seeds.begin() + seedCount, [this](int a, int b) { return distance[a] < distance[b]; });
+    sort(seedDistances.begin(), seedDistances.begin() + seedCount);
+
+    int nextSeed = 0;
+    int head = 0;
+    int tail = 0;
+    while (nextSeed < seedCount || head < tail) {
+        int tile;
+        if (head == tail || (nextSeed < seedCount && seedDistances[nextSeed] <= distance[queue[head]])) {
+            // A seed improved through the queue was already expanded from there.
+            bool stale = distance[seeds[nextSeed]] < seedDistances[nextSeed];
+            tile = seeds[nextSeed++];
+            if (stale) continue;
+        } else {
+            tile = queue[head++];
+        }
+        if (distance[tile] == UNREACHABLE) continue;
+
+        for (int n = 0; n < geometry.neighborCount[tile]; n++) {
+            int neighbor = geometry.neighbors[tile][n];
+            if (!walkable[neighbor] || distance[neighbor] <= distance[tile] + 1) continue;
+            distance[neighbor] = distance[tile] + 1;
+            queue[tail++] = neighbor;
+        }
+    }
+}
+
+void DistanceFields::reset() {
+    toOpponent.reset();
+    toNeutral.reset();
+    toOwnFrontier.reset();
+}
+
+void DistanceFields::update(const Bitboards &masks) {
+    PROFILE_ZONE("distances");
+    Bitboard walkableTiles = masks.walkable();
+    Bitboard neutralTiles = walkableTiles.andNot(masks.own | masks.opponent);
+    Bitboard frontierTiles = frontier(walkableTiles & masks.own, walkableTiles.andNot(masks.own));
+
+    TileMask walkable;
+    TileMask opponent;
+    TileMask neutral;
+    TileMask ownFrontier;
+    for (int tile = 0; tile < geometry.tileCount; tile++) {
+        walkable[tile] = walkableTiles.test(tile);
+        opponent[tile] = walkable[tile] && masks.opponent.test(tile);
+        neutral[tile] = neutralTiles.test(tile);
+        ownFrontier[tile] = frontierTiles.test(tile);
+    }
+
+    toOpponent.update(opponent, walkable);
+    toNeutral.update(neutral, walkable);
+    toOwnFrontier.update(ownFrontier, walkable);
+}
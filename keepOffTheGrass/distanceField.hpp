@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "config.hpp"
+#include "board.hpp"
+#include "bitboard.hpp"
+
+using TileMask = array<bool, MAX_TILES>;
+
+// Multi-source BFS distance over walkable tiles, kept up to date between turns instead of being rebuilt. When
+// sources or walkable tiles disappear, only the tiles whose shortest path went through them are invalidated; those
+// and any new sources are then relaxed in distance order from the still valid boundary.
+class DistanceField {
+public:
+    static constexpr int UNREACHABLE = INT8_MAX;
+
+    // Forgets everything, the next update() rebuilds from scratch.
+    void reset() { initialized = false; }
+    void update(const TileMask &newSources, const TileMask &newWalkable);
+    int operator[](int tile) const { return distance[tile]; }
+
+private:
+    void rebuild();
+    void invalidate(int tile);
+    void relax(int seedCount);
+
+    bool initialized = false;
+    TileMask sources;
+    TileMask walkable;
+    array<int8_t, MAX_TILES> distance;
+    array<int8_t, MAX_TILES> seeds;
+    array<int8_t, MAX_TILES> seedDistances;
+    array<int8_t, MAX_TILES> queue;
+    array<int8_t, MAX_TILES> queuedDistances;
+    TileMask invalid;
+    TileMask seeded;
+};
+
+// Per turn distance knowledge for movement and build decisions.
+struct DistanceFields {
+    void reset();
+    void update(const Bitboards &masks);
+
+    DistanceField toOpponent;
+    DistanceField toNeutral;
+    DistanceField toOwnFrontier;
+};
+
+extern DistanceFields distances;
@@ -1,211 +1,187 @@
 #include <algorithm>
 #include <array>
 #include <assert.h>
-#include <chrono>
 #include <iostream>
 #include <vector>
 #include <random>
 #include <string>
 #include <tuple>
 
-namespace Settings {
-    const int freeTileWeight = 4;
-    const int opponentTileWeight = 32;
-    const int ownTileWeight = 2;
-
-    const float freeTileScrapWeight = 1;
-    const float opponentTileScrapWeight = 1.5;
-    const float ownTileScrapWeight = -1;
-
-    const int tilesPerTower = 20;
-}
-
-using namespace std;
-
-#define PROFILE_START(ID) auto _ID_ = chrono::steady_clock::now()
-#define PROFILE_STOP(ID, MESSAGE) fprintf(stderr, MESSAGE, chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - _ID_).count())
-
-const int MAX_WIDTH = 15;
-const int MAX_HEIGHT = 7;
-constexpr int MAX_TILES = MAX_WIDTH * MAX_HEIGHT;
-const int MAX_ACTIONS = 100;
-const int BUILD_COST = 10;
-
-using Coord = tuple<int, int>;
-int x(Coord coord) { return get<0>(coord); }
-int y(Coord coord) { return get<1>(coord); }
-Coord coord(int x, int y) { return make_tuple(x, y); }
-
-struct Tile {
-    Tile() { neighbors.reserve(4); }
-
-    int scrapAmount;
-    int owner;
-    int units;
-    int recycler;
-    int canBuild;
-    int canSpawn;
-    int willBeScrapped;
-    Coord coord;
-    vector<vector<Tile>::iterator> neighbors;
-};
-using TileRow = vector<Tile>;
-using TileMatrix = vector<TileRow>;
-using TileIterator = TileRow::iterator;
-using TileIterators = vector<TileRow::iterator>;
-#define GET_TILE_ITERATOR(ROW, COLUMN) (board[ROW].begin() + (COLUMN))
+#include "../common/inputReader.hpp"
+#include "../common/random.hpp"
+#include "../common/replay.hpp"
+#include "../common/turnBudget.hpp"
+#include "config.hpp"
+#include "board.hpp"
+#include "actions.hpp"
+#include "rollout.hpp"
+#include "bitboard.hpp"
+#include "boardKernels.hpp"
+#include "distanceField.hpp"
+#include "regions.hpp"
+#include "recyclerYield.hpp"
+#include "dispatch.hpp"
+#include "tileEvaluation.hpp"
 
 struct RobotTile {
-    RobotTile(TileIterator tile, int robots) : tile(tile), robots(robots) {}
-    TileIterator tile;
+    RobotTile(int tile, int robots) : tile(tile), robots(robots) {}
+    int tile;
     int robots;
 };
 using RobotTiles = vector<RobotTile>;
+using TileIndices = vector<int>;
 
-enum class ACTION {
-    MOVE,
-    BUILD,
-    SPAWN,
-    WAIT,
-    MESSAGE,
-    Count
-};
-using ActionStringArray = array<char[8], static_cast<size_t>(ACTION::Count)>;
-ActionStringArray actionToString{"MOVE", "BUILD", "SPAWN", "WAIT", "MESSAGE"};
-
-struct Action {
-    static Action move(int amount, Coord pos, Coord target) { return Action{ACTION::MOVE, amount, pos, target}; }
-    static Action build(Coord pos) { return Action{ACTION::BUILD, 0, pos}; }
-    static Action spawn(int amount, Coord pos) { return Action{ACTION::SPAWN, amount, pos}; }
-    static Action wait() { return Action{ACTION::WAIT}; }
-
-    ACTION kind;
-    int amount;
-    Coord pos;
-    Coord target;
-};
-using Actions = vector<Action>;
-
-enum class DIRECTION {
-    UP, DOWN, LEFT, RIGHT, Count
-};
-
-int boardWidth;
-int boardHeight;
 int currentMatter;
 int opponentMatter;
-TileMatrix board;
+Board board;
 RobotTiles ownRobotsTiles;
 RobotTiles opponentRobotsTiles;
-TileIterators ownTiles;
-TileIterators ownRecyclerTiles;
+TileIndices ownTiles;
+TileIndices ownRecyclerTiles;
 Actions nextActions;
+vector<Actions> candidateActions;
+ThreadPool threadPool(Settings::rolloutThreads);
+RolloutEngine rolloutEngine(threadPool);
 
-minstd_rand randomEngine = minstd_rand(random_device()());
-uniform_int_distribution<int> uniformGenerator;
+FastRandom randomEngine = FastRandom(random_device()());
 
-const int moveNeighborWeights[3] = { Settings::freeTileWeight, Settings::opponentTileWeight, Settings::ownTileWeight };
-const int maxMoveNeighborWeightsSum = *max_element(begin(moveNeighborWeights), end(moveNeighborWeights)) * 4;
-
-void init();
-void updateGameStatus();
+void init(InputReader& in);
+void updateGameStatus(InputReader& in);
 void calculateOrders();
 void sendOrders();
+void playTurn(InputReader& in);
 void buildStuff();
-bool tryBuildRecycler();
-Tile* getBestTileForRecycler();
-bool spawnRobotSomewhere();
-void moveByRandomWalk(const Tile& tile);
+bool spawnRobotSomewhere(FloatTileArray& pressure);
+void moveByRandomWalk(int tile, int units);
 void moveByRandomWalk(const RobotTile& tile);
-TileIterator coordTile(const Coord& coord);
-tuple<bool, Coord> getNeighbor(const Coord& coord, DIRECTION direction);
-tuple<int, int, int> getTileReachableScrap(Tile& tile);
-vector<int>& getWeigthedNeighbors(const Tile& tile);
+WeightedSampler<DIRECTION_COUNT> getWeigthedNeighbors(int tile, const TileNeighbors& neighbors);
+int getDistanceToUnowned(int tile);
+
+void playTurn(InputReader& in) {
+    PROFILE_ZONE("turn");
+    updateGameStatus(in);
+    calculateOrders();
+    sendOrders();
+}
 
-int main()
+#if !defined(BENCH) && !defined(REFEREE)
+int main([[maybe_unused]] int argc, [[maybe_unused]] char** argv)
 {
-    cin.peek();
-    PROFILE_START(init);
-    init();
-    PROFILE_STOP(init, "Init time: %ldµs\n");
-
-    while (1) {
-        cin.peek();
-        PROFILE_START(turn);
-        updateGameStatus();
-        calculateOrders();
-        sendOrders();
-        PROFILE_STOP(turn, "Turn time: %ldµs\n");
+    TurnBudget::get().configure();
+#ifdef REPLAY
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <replay log>\n", argv[0]);
+        return 1;
+    }
+    return runReplay(argv[1], init, playTurn);
+#else
+#ifdef TUNABLE
+    if (argc > 1) Settings::loadParameters(argv[1]);
+#endif
+#ifdef RECORD_REPLAY
+    ReplayRecorder::get().start(cerr);
+#endif
+    InputReader& in = InputReader::get();
+    in.peek();
+    {
+        PROFILE_ZONE("init");
+        init(in);
     }
-}
 
-void init() {
-    cin >> boardWidth >> boardHeight; cin.ignore();
-    board.reserve(boardHeight);
-    board.resize(boardHeight);
-    for (auto& row : board) {
-        row.reserve(boardWidth);
-        row.resize(boardWidth);
+    while (in.peek() != EOF) {
+        TurnBudget::get().startTurn();
+        ReplayRecorder::get().beginTurn();
+        playTurn(in);
+        ReplayRecorder::get().endTurn();
+        PROFILE_TURN();
     }
+    PROFILE_DUMP();
+#endif
+}
+#endif
+
+void init(InputReader& in) {
+    int boardWidth = in.readInt();
+    int boardHeight = in.readInt();
+    geometry.resize(boardWidth, boardHeight);
+    bitboardGeometry.resize();
+    selectBoardKernels(boardWidth, boardHeight);
+    tileEvaluator.resize();
+    distances.reset();
     ownRobotsTiles.reserve(MAX_TILES);
     opponentRobotsTiles.reserve(MAX_TILES);
     ownTiles.reserve(MAX_TILES);
+    ownRecyclerTiles.reserve(MAX_TILES);
     nextActions.reserve(MAX_ACTIONS);
+    candidateActions.resize(Settings::rolloutCandidates);
+    for (auto& candidate : candidateActions) {
+        candidate.reserve(MAX_ACTIONS);
+    }
 }
 
-void updateGameStatus() {
+void updateGameStatus(InputReader& in) {
+    PROFILE_ZONE("update");
     ownRobotsTiles.clear();
     opponentRobotsTiles.clear();
     ownTiles.clear();
     ownRecyclerTiles.clear();
-    cin >> currentMatter >> opponentMatter; cin.ignore();
-    for (int i = 0; i < board.size(); i++) {
-        for (int j = 0; j < board[i].size(); j++) {
-            Tile& tile = board[i][j];
-            cin >> tile.scrapAmount;
-            cin >> tile.owner;
-            cin >> tile.units;
-            cin >> tile.recycler;
-            cin >> tile.canBuild;
-            cin >> tile.canSpawn;
-            cin >> tile.willBeScrapped;
-            cin.ignore();
-
-            tile.coord = coord(j, i);
-            assert(tile.units == 0 || tile.owner != -1);
-            if (tile.units > 0) {
-                RobotTile robotTile(GET_TILE_ITERATOR(i, j), tile.units);
-                if (tile.owner == 1) ownRobotsTiles.push_back(robotTile);
-                else opponentRobotsTiles.push_back(robotTile);
-            }
-            if (tile.owner == 1) {
-                ownTiles.push_back(GET_TILE_ITERATOR(i, j));
-                if (tile.recycler == 1) ownRecyclerTiles.push_back(GET_TILE_ITERATOR(i, j));
-            }
+    currentMatter = in.readInt();
+    opponentMatter = in.readInt();
+    for (int tile = 0; tile < geometry.tileCount; tile++) {
+        board.scrapAmount[tile] = in.readInt();
+        board.owner[tile] = in.readInt();
+        board.units[tile] = in.readInt();
+        board.recycler[tile] = in.readInt();
+        board.canBuild[tile] = in.readInt();
+        board.canSpawn[tile] = in.readInt();
+        board.willBeScrapped[tile] = in.readInt();
+
+        assert(board.units[tile] == 0 || board.owner[tile] != -1);
+        if (board.units[tile] > 0) {
+            RobotTile robotTile(tile, board.units[tile]);
+            if (board.owner[tile] == 1) ownRobotsTiles.push_back(robotTile);
+            else opponentRobotsTiles.push_back(robotTile);
         }
-    }
-
-    for (int i = 0; i < board.size(); i++) {
-        for (int j = 0; j < board[i].size(); j++) {
-            Tile& tile = board[i][j];
-            tile.neighbors.clear();
-
-            for (int d = 0; d < static_cast<int>(DIRECTION::Count); d++) {
-                DIRECTION direction = static_cast<DIRECTION>(d);
-                auto [valid, coord] = getNeighbor(tile.coord, direction);
-                if (valid && coordTile(coord)->recycler == 0) {
-                    tile.neighbors.push_back(coordTile(coord));
-                }
-            }
+        if (board.owner[tile] == 1) {
+            ownTiles.push_back(tile);
+            if (board.recycler[tile] == 1) ownRecyclerTiles.push_back(tile);
         }
     }
+    bitboards.update(board);
+    distances.update(bitboards);
+    regions.update(bitboards);
+    tileEvaluator.evaluate(board, tileEvaluation);
 }
 
 void calculateOrders() {
-    for (auto robotsTile : ownRobotsTiles) {
-        moveByRandomWalk(robotsTile);
+    PROFILE_ZONE("orders");
+    // Every region is settled, whatever we do can't change the score.
+    if (regions.contested.empty()) return;
+
+    // The first candidate dispatches robots to distinct targets, the others are random walks.
+    for (auto& candidate : candidateActions) {
+        PROFILE_ZONE("candidate");
+        if (&candidate == &candidateActions.front()) {
+            robotDispatch.dispatch(board, bitboards.own & bitboards.units & regions.contested,
+                                   regions.contested.andNot(bitboards.own), nextActions);
+            // Units past the solver's capacity walk like in the other candidates rather than stand idle.
+            for (Bitboard tiles = robotDispatch.unplannedTiles(); !tiles.empty(); tiles.reset(tiles.first())) {
+                moveByRandomWalk(tiles.first(), robotDispatch.unplannedUnits(tiles.first()));
+            }
+        } else {
+            for (auto robotsTile : ownRobotsTiles) {
+                if (regions.contested.test(robotsTile.tile)) moveByRandomWalk(robotsTile);
+            }
+        }
+        buildStuff();
+        candidate.swap(nextActions);
+        nextActions.clear();
     }
-    buildStuff();
+
+    SimState root{board, {}, 0};
+    root.matter[OWN_PLAYER] = currentMatter;
+    root.matter[OPPONENT_PLAYER] = opponentMatter;
+    nextActions.swap(candidateActions[rolloutEngine.selectBest(root, candidateActions, randomEngine())]);
 }
 
 void sendOrders() {
@@ -235,159 +211,93 @@ void sendOrders() {
 }
 
 void buildStuff() {
+    PROFILE_ZONE("build");
     int remainingMatter = currentMatter;
 
-    while (remainingMatter >= BUILD_COST) {
-        bool RecyclerBuilt = tryBuildRecycler();
-        bool robotBuilt = RecyclerBuilt ? false : spawnRobotSomewhere();
-
-        remainingMatter -= RecyclerBuilt || robotBuilt ? BUILD_COST : 0;
+    int allowedRecyclers =
+        static_cast<int>(ownTiles.size()) / Settings::tilesPerTower - static_cast<int>(ownRecyclerTiles.size());
+    int recyclerTiles[MAX_TILES];
+    int recyclerCount = selectRecyclerTiles(tileEvaluation, bitboards.canBuild & regions.contested,
+                                            min(allowedRecyclers, remainingMatter / BUILD_COST), recyclerTiles);
+    for (int i = 0; i < recyclerCount; i++) {
+        nextActions.push_back(Action::build(geometry.coord(recyclerTiles[i])));
+        remainingMatter -= BUILD_COST;
     }
-}
 
-bool tryBuildRecycler() {
-    if (ownRecyclerTiles.size() >= ownTiles.size() / Settings::tilesPerTower) return false;
-
-    if (Tile* bestTileForRecycler = getBestTileForRecycler()) {
-        nextActions.push_back(Action::build(bestTileForRecycler->coord));
-        return true;
+    FloatTileArray pressure = tileEvaluation.frontierPressure;
+    while (remainingMatter >= BUILD_COST && spawnRobotSomewhere(pressure)) {
+        remainingMatter -= BUILD_COST;
     }
-    
-    return false;
 }
 
-Tile* getBestTileForRecycler() {
-    Tile* bestTile = nullptr;
-
-    float bestTileValue = 0;
-    for (auto tile : ownTiles) {
-        if (tile->units == 0) {
-            auto [free, opponent, own] = getTileReachableScrap(*tile);
-            float currentTileValue = free * Settings::freeTileScrapWeight + opponent * Settings::opponentTileScrapWeight + own * Settings::ownTileScrapWeight;
-            if (currentTileValue > bestTileValue) {
-                bestTileValue = currentTileValue;
-                bestTile = &*tile;
-            }
+// Reinforces the tiles the opponent outnumbers most, each spawn easing the pressure on its tile. Once no tile is
+// outnumbered any tile will do.
+bool spawnRobotSomewhere(FloatTileArray& pressure) {
+    // Contested regions only hold walkable tiles, so recyclers are already left out.
+    Bitboard spawnTiles = bitboards.own & regions.contested;
+    if (spawnTiles.empty()) return false;
+
+    float maxPressure = 0;
+    Bitboard pressedTiles{0};
+    for (Bitboard tiles = spawnTiles; !tiles.empty(); tiles.reset(tiles.first())) {
+        int tile = tiles.first();
+        if (pressure[tile] > maxPressure) {
+            maxPressure = pressure[tile];
+            pressedTiles = Bitboard{0};
         }
+        if (pressure[tile] > 0 && pressure[tile] == maxPressure) pressedTiles.set(tile);
     }
+    if (!pressedTiles.empty()) spawnTiles = pressedTiles;
 
-    return bestTile;
-}
-
-bool spawnRobotSomewhere() {
-    if (ownRecyclerTiles.size() == ownTiles.size()) return false;
-
-    Coord randomCoord;
-    bool freeTile;
-    do {
-        auto tile = ownTiles[uniformGenerator(randomEngine) % ownTiles.size()];
-        if ((freeTile = tile->recycler == 0))
-            randomCoord = tile->coord;
-    }while(!freeTile);
+    for (int skip = randomEngine.below(spawnTiles.count()); skip > 0; skip--) {
+        spawnTiles.reset(spawnTiles.first());
+    }
+    int randomTile = spawnTiles.first();
+    pressure[randomTile]--;
 
-    nextActions.push_back(Action::spawn(1, randomCoord));
+    nextActions.push_back(Action::spawn(1, geometry.coord(randomTile)));
     return true;
 }
 
-void moveByRandomWalk(const Tile& tile) {
-    assert(tile.owner == 1 && tile.units > 0);
+void moveByRandomWalk(int tile, int units) {
+    assert(board.owner[tile] == 1 && units > 0 && units <= board.units[tile]);
 
-    auto weigthedNeighbors = getWeigthedNeighbors(tile);
-    vector<tuple<int, Coord>> moves;
-    moves.resize(tile.neighbors.size());
-    for (int i = 0; i < tile.units; i++) {
-        int neighborNum = weigthedNeighbors[uniformGenerator(randomEngine) % weigthedNeighbors.size()];
-        auto& move = moves[neighborNum];
-        get<0>(move)++;
-        get<1>(move) = tile.neighbors[neighborNum]->coord;
+    TileNeighbors neighbors = board.passableNeighbors(tile);
+    WeightedSampler<DIRECTION_COUNT> weigthedNeighbors = getWeigthedNeighbors(tile, neighbors);
+    if (weigthedNeighbors.totalWeight() == 0) return;
+
+    array<int, DIRECTION_COUNT> moves{};
+    for (int i = 0; i < units; i++) {
+        moves[weigthedNeighbors.sample(randomEngine)]++;
     }
 
-    for (auto move : moves) {
-        if (get<0>(move) > 0) {
-            nextActions.push_back(Action::move(get<0>(move), tile.coord, get<1>(move)));
+    for (int i = 0; i < neighbors.count; i++) {
+        if (moves[i] > 0) {
+            nextActions.push_back(Action::move(moves[i], geometry.coord(tile), geometry.coord(neighbors.tiles[i])));
         }
     }
 }
 
 void moveByRandomWalk(const RobotTile& tile) {
-    moveByRandomWalk(*tile.tile);
-}
-
-TileIterator coordTile(const Coord& coord) {
-    return GET_TILE_ITERATOR(y(coord), x(coord));
+    moveByRandomWalk(tile.tile, tile.robots);
 }
 
-#define BORDER_MOVE(v, c, m) if (v != c) { v += m; differentCoord = true; }
-tuple<bool, Coord> getNeighbor(const Coord& coordinate, DIRECTION direction) {
-    auto [x, y] = coordinate;
-    bool differentCoord = false;
-    switch (direction) {
-        case DIRECTION::UP:
-            BORDER_MOVE(y, 0, -1);
-            break;
-        case DIRECTION::DOWN:
-            BORDER_MOVE(y, boardHeight-1, 1);
-            break;
-        case DIRECTION::LEFT:
-            BORDER_MOVE(x, 0, -1);
-            break;
-        case DIRECTION::RIGHT:
-            BORDER_MOVE(x, boardWidth-1, 1);
-        default: ;
-    }
-    return make_tuple(differentCoord, coord(x, y));
-}
-
-tuple<int, int, int> getTileReachableScrap(Tile& tile) {
-    int own = 0;
-    int opponent = 0;
-    int free = 0;
-
-    switch(tile.owner) {
-        case 1:
-            own += tile.scrapAmount;
-            break;
-        case 0:
-            free += tile.scrapAmount;
-            break;
-        case -1:
-            opponent += tile.scrapAmount;
-            break;
-        default: ;
+WeightedSampler<DIRECTION_COUNT> getWeigthedNeighbors(int tile, const TileNeighbors& neighbors) {
+    // Function static, so a tunable build reads the weights after loading them.
+    static const int moveNeighborWeights[3] = { Settings::freeTileWeight, Settings::opponentTileWeight, Settings::ownTileWeight };
+    WeightedSampler<DIRECTION_COUNT> weightedNeighbors;
+
+    int tileDistance = getDistanceToUnowned(tile);
+    for(int i = 0; i < neighbors.count; i++) {
+        int neighbor = neighbors.tiles[i];
+        int weight = moveNeighborWeights[board.owner[neighbor]+1];
+        if (getDistanceToUnowned(neighbor) < tileDistance) weight *= Settings::closerNeighborWeightFactor;
+        weightedNeighbors.add(weight);
     }
 
-    for (int d=0; d < static_cast<int>(DIRECTION::Count); d++) {
-        DIRECTION direction = static_cast<DIRECTION>(d);
-        auto neighborCoord = getNeighbor(tile.coord, direction);
-        if (get<0>(neighborCoord)) {
-            TileIterator tileIter = coordTile(get<1>(neighborCoord));
-            switch(tileIter->owner) {
-                case 1:
-                    own += tileIter->scrapAmount;
-                    break;
-                case 0:
-                    free += tileIter->scrapAmount;
-                    break;
-                case -1:
-                    opponent += tileIter->scrapAmount;
-                    break;
-                default: ;
-            }
-        }        
-    }
-
-    return make_tuple(free, opponent, own);
+    return weightedNeighbors;
 }
 
-vector<int>& getWeigthedNeighbors(const Tile& tile) {
-    static vector<int> weightedNeighbors;
-    weightedNeighbors.reserve(maxMoveNeighborWeightsSum);
-    weightedNeighbors.clear();
-    
-    for(int i = 0; i < tile.neighbors.size(); i++) {
-        auto& neighbor = tile.neighbors[i];
-        weightedNeighbors.insert(end(weightedNeighbors), moveNeighborWeights[neighbor->owner+1], i);
-    }
-
-    return weightedNeighbors;
+int getDistanceToUnowned(int tile) {
+    return min(distances.toNeutral[tile], distances.toOpponent[tile]);
 }
@@ -0,0 +1,34 @@
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <utility>
+
+#include "recyclerYield.hpp"
+
+int selectRecyclerTiles(const TileEvaluation &evaluation, Bitboard candidates, int maxCount, int *tiles) {
+    if (maxCount <= 0) return 0;
+
+    array<pair<float, int>, MAX_TILES> ranked;
+    int candidateCount = 0;
+    for (; !candidates.empty(); candidates.reset(candidates.first())) {
+        int tile = candidates.first();
+        float value = evaluation.recyclerYield[tile];
+        if (value > 0) ranked[candidateCount++] = {value, tile};
+    }
+    sort(ranked.begin(), ranked.begin() + candidateCount, greater<pair<float, int>>());
+
+    int selected = 0;
+    Bitboard taken{0};
+    for (int i = 0; i < candidateCount && selected < maxCount; i++) {
+        int tile = ranked[i].second;
+        Bitboard area{0};
+        area.set(tile);
+        for (int j = 0; j < geometry.neighborCount[tile]; j++) {
+            area.set(geometry.neighbors[tile][j]);
+        }
+        if (!(area & taken).empty()) continue;
+        taken |= area;
+        tiles[selected++] = tile;
+    }
+    return selected;
+}
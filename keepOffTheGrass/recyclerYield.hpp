@@ -0,0 +1,11 @@
+#pragma once
+
+#include "config.hpp"
+#include "board.hpp"
+#include "bitboard.hpp"
+#include "tileEvaluation.hpp"
+
+// Picks up to maxCount candidate tiles for recyclers in one pass, best first by TileEvaluation::recyclerYield, whose
+// areas (the tile and its in-map neighbors, every tile the recycler harvests) don't overlap and whose value is
+// positive. Returns how many were written to tiles.
+int selectRecyclerTiles(const TileEvaluation &evaluation, Bitboard candidates, int maxCount, int *tiles);
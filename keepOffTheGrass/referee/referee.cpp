@@ -0,0 +1,181 @@
+#include <random>
+#include <sstream>
+
+#include "../../common/tournament.hpp"
+#include "../../common/tuner.hpp"
+#include "../actions.hpp"
+#include "../board.hpp"
+#include "../boardKernels.hpp"
+#include "../config.hpp"
+#include "../simulator.hpp"
+
+// Local referee for Keep Off The Grass on top of the bot's own simulateTurn(). The board is kept as seat 0 sees it,
+// seat 0 plays OWN_PLAYER and seat 1 OPPONENT_PLAYER, and every bot gets its input from its own point of view.
+namespace {
+    const int MAX_TURNS = 200;
+    // The match also ends once this many turns passed without a tile changing scrap or owner.
+    const int MAX_STALE_TURNS = 20;
+    const int START_MATTER = 10;
+    const int GRASS_PERCENT = 15;
+    const int MAX_START_SCRAP = 10;
+
+    // simulateTurn() works on the process wide geometry, so every match of a tournament shares one map size.
+    int mapWidth = 13;
+    int mapHeight = 6;
+
+    int ownerOf(int seat) {
+        return seat == 0 ? OWN_PLAYER : OPPONENT_PLAYER;
+    }
+
+    // Point symmetric random scrap like the real maps, and for each player a start tile whose neighbors it owns
+    // with a robot on each.
+    SimState generateMap(uint64_t seed) {
+        mt19937_64 random(seed);
+        SimState state{};
+        Board &board = state.board;
+        int tileCount = geometry.tileCount;
+        for (int tile = 0; tile < tileCount; tile++) {
+            int mirror = tileCount - 1 - tile;
+            if (mirror < tile) continue;
+            int scrap = static_cast<int>(random() % 100) < GRASS_PERCENT ? 0 : 1 + random() % MAX_START_SCRAP;
+            board.scrapAmount[tile] = board.scrapAmount[mirror] = scrap;
+        }
+        fill_n(board.owner.begin(), tileCount, NO_OWNER);
+
+        int startX = 1 + random() % max(1, mapWidth / 2 - 2);
+        int startY = 1 + random() % (mapHeight - 2);
+        int start = geometry.index(startX, startY);
+        for (int seat = 0; seat < 2; seat++) {
+            int tile = seat == 0 ? start : tileCount - 1 - start;
+            board.scrapAmount[tile] = max<int>(board.scrapAmount[tile], 1);
+            board.owner[tile] = ownerOf(seat);
+            for (int i = 0; i < geometry.neighborCount[tile]; i++) {
+                int neighbor = geometry.neighbors[tile][i];
+                board.scrapAmount[neighbor] = max<int>(board.scrapAmount[neighbor], 1);
+                board.owner[neighbor] = ownerOf(seat);
+                board.units[neighbor] = 1;
+            }
+        }
+        state.matter.fill(START_MATTER);
+        return state;
+    }
+
+    string formatTurn(const SimState &state, int seat) {
+        const Board &board = state.board;
+        int me = ownerOf(seat);
+        int foe = ownerOf(1 - seat);
+        string text = to_string(state.matter[me]) + " " + to_string(state.matter[foe]) + "\n";
+        for (int tile = 0; tile < geometry.tileCount; tile++) {
+            int owner = board.owner[tile] == me ? 1 : board.owner[tile] == foe ? 0 : -1;
+            bool canSpawn = owner == 1 && board.scrapAmount[tile] > 0 && !board.recycler[tile];
+            bool canBuild = canSpawn && board.units[tile] == 0;
+            bool inRangeOfRecycler = board.recycler[tile];
+            for (int i = 0; i < geometry.neighborCount[tile]; i++) {
+                inRangeOfRecycler |= board.recycler[geometry.neighbors[tile][i]] != 0;
+            }
+
+            char line[64];
+            snprintf(line, sizeof(line), "%d %d %d %d %d %d %d\n", board.scrapAmount[tile], owner, board.units[tile],
+                     board.recycler[tile], canBuild, canSpawn, inRangeOfRecycler);
+            text += line;
+        }
+        return text;
+    }
+
+    bool isInMap(int x, int y) {
+        return x >= 0 && x < mapWidth && y >= 0 && y < mapHeight;
+    }
+
+    // Malformed or off-map commands are dropped, the rest is validated by simulateTurn() like the referee does.
+    Actions parseActions(const string &line) {
+        Actions actions;
+        istringstream commands(line);
+        string command;
+        while (getline(commands, command, ';')) {
+            istringstream words(command);
+            string kind;
+            int amount, x, y, toX, toY;
+            words >> kind;
+            if (kind == "MOVE" && words >> amount >> x >> y >> toX >> toY && isInMap(x, y) && isInMap(toX, toY)) {
+                actions.push_back(Action::move(amount, coord(x, y), coord(toX, toY)));
+            } else if (kind == "BUILD" && words >> x >> y && isInMap(x, y)) {
+                actions.push_back(Action::build(coord(x, y)));
+            } else if (kind == "SPAWN" && words >> amount >> x >> y && isInMap(x, y)) {
+                actions.push_back(Action::spawn(amount, coord(x, y)));
+            }
+        }
+        return actions;
+    }
+
+    int countTiles(const Board &board, int owner) {
+        return count(board.owner.begin(), board.owner.begin() + geometry.tileCount, owner);
+    }
+
+    MatchResult playMatch(uint64_t seed, Match &match) {
+        SimState state = generateMap(seed);
+        MatchResult result;
+        int staleTurns = 0;
+        array<string, 2> inputs;
+        array<vector<string>, 2> outputs;
+
+        while (result.turns < MAX_TURNS && staleTurns < MAX_STALE_TURNS) {
+            for (int seat = 0; seat < 2; seat++) {
+                inputs[seat] = result.turns == 0 ? to_string(mapWidth) + " " + to_string(mapHeight) + "\n" : "";
+                inputs[seat] += formatTurn(state, seat);
+            }
+            if (!match.playTurn(inputs, 1, outputs)) break;
+            result.turns++;
+
+            Board before = state.board;
+            simulateTurn(state, parseActions(outputs[0][0]), parseActions(outputs[1][0]));
+            bool changed = false;
+            for (int tile = 0; tile < geometry.tileCount && !changed; tile++) {
+                changed = before.scrapAmount[tile] != state.board.scrapAmount[tile] ||
+                          before.owner[tile] != state.board.owner[tile];
+            }
+            staleTurns = changed ? 0 : staleTurns + 1;
+            if (countTiles(state.board, OWN_PLAYER) == 0 || countTiles(state.board, OPPONENT_PLAYER) == 0) break;
+        }
+
+        for (int seat = 0; seat < 2; seat++) {
+            result.scores[seat] = countTiles(state.board, ownerOf(seat));
+        }
+        if (result.scores[0] != result.scores[1]) result.winner = result.scores[0] > result.scores[1] ? 0 : 1;
+        return result;
+    }
+
+    bool parseGameFlag(const string &flag, const char *value) {
+        if (flag == "--width") mapWidth = atoi(value);
+        else if (flag == "--height") mapHeight = atoi(value);
+        else return false;
+        return true;
+    }
+
+    bool isMapSizeSupported() {
+        return mapWidth >= 6 && mapWidth <= MAX_WIDTH && mapHeight >= 3 && mapHeight <= MAX_HEIGHT;
+    }
+}
+
+// "referee <bot A> <bot B> [flags]" plays a tournament, "referee tune <tunable bot> [flags]" tunes the Settings
+// listed in TUNED_PARAMETERS.
+int main(int argc, char **argv) {
+    bool tune = argc > 1 && string(argv[1]) == "tune";
+    TournamentOptions options;
+    TunerOptions tuner;
+    bool parsed = tune ? parseTunerOptions(argc - 1, argv + 1, options, tuner, parseGameFlag)
+                       : parseTournamentOptions(argc, argv, 2, options, parseGameFlag);
+    if (!parsed || !isMapSizeSupported()) {
+        fprintf(stderr,
+                "Usage: %s <bot A> <bot B> [--games N] [--seed S] [--threads T] [--first-timeout MS] [--timeout MS]\n"
+                "       %s tune <tunable bot> [--iterations N] [--games N] [--verify-games N] [--output PATH] ...\n"
+                "       [--width W] [--height H]   map size, at most %dx%d\n",
+                argv[0], argv[0], MAX_WIDTH, MAX_HEIGHT);
+        return 1;
+    }
+
+    geometry.resize(mapWidth, mapHeight);
+    bitboardGeometry.resize();
+    selectBoardKernels(mapWidth, mapHeight);
+    if (tune) return runTuner(options, tuner, {TUNED_PARAMETERS(PARAMETER_INFO)}, playMatch);
+    return runTournament(options, playMatch);
+}
@@ -0,0 +1,32 @@
+#include <algorithm>
+
+#include "regions.hpp"
+
+RegionAnalysis regions;
+
+void RegionAnalysis::update(const Bitboards &masks) {
+    PROFILE_ZONE("regions");
+    regionCount = 0;
+    fill_n(regionIds.begin(), geometry.tileCount, NO_REGION);
+    tiles.fill(Bitboard{0});
+
+    Bitboard remaining = masks.walkable();
+    while (!remaining.empty()) {
+        Bitboard region = floodFill(Bitboard::single(remaining.first()), remaining);
+        remaining = remaining.andNot(region);
+
+        bool hasOwn = !(region & masks.own).empty();
+        bool hasOpponent = !(region & masks.opponent).empty();
+        REGION label;
+        if (!hasOwn) label = hasOpponent ? REGION::LOST : REGION::NEUTRAL;
+        else label = region.andNot(masks.own).empty() ? REGION::OWNED : REGION::CONTESTED;
+
+        labels[regionCount] = label;
+        tiles[static_cast<int>(label)] |= region;
+        for (Bitboard left = region; !left.empty(); left.reset(left.first())) {
+            regionIds[left.first()] = regionCount;
+        }
+        regionCount++;
+    }
+    contested = tiles[static_cast<int>(REGION::CONTESTED)];
+}
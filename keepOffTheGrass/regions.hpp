@@ -0,0 +1,39 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "config.hpp"
+#include "board.hpp"
+#include "bitboard.hpp"
+
+// Once recyclers turn tiles to grass the map splits into islands of walkable tiles that can't affect each other.
+enum class REGION {
+    // Every tile is ours, nothing left to do there.
+    OWNED,
+    // We own tiles and there is still something to take.
+    CONTESTED,
+    // Nobody owns a tile yet.
+    NEUTRAL,
+    // Only the opponent is there, we have no way in.
+    LOST,
+    Count
+};
+
+struct RegionAnalysis {
+    void update(const Bitboards &masks);
+    // Walkable tiles only, grass and recyclers belong to no region.
+    bool inRegion(int tile) const { return regionIds[tile] != NO_REGION; }
+    REGION label(int tile) const { return labels[regionIds[tile]]; }
+
+    static constexpr int NO_REGION = -1;
+
+    int regionCount;
+    array<int8_t, MAX_TILES> regionIds;
+    array<REGION, MAX_TILES> labels;
+    // Union of the regions with each label.
+    array<Bitboard, static_cast<int>(REGION::Count)> tiles;
+    Bitboard contested;
+};
+
+extern RegionAnalysis regions;
@@ -0,0 +1,102 @@
+#include <algorithm>
+#include <cassert>
+
+#include "../common/turnBudget.hpp"
+#include "rollout.hpp"
+
+void randomPolicy(const SimState &state, int player, FastRandom &rng, Actions &actions) {
+    const Board &board = state.board;
+    actions.clear();
+
+    array<int8_t, MAX_TILES> spawnTiles;
+    int spawnTileCount = 0;
+    for (int tile = 0; tile < geometry.tileCount; tile++) {
+        if (board.owner[tile] != player || board.recycler[tile] || board.scrapAmount[tile] == 0) continue;
+        spawnTiles[spawnTileCount++] = tile;
+
+        if (board.units[tile] == 0) continue;
+        TileNeighbors neighbors;
+        neighbors.count = 0;
+        for (int i = 0; i < geometry.neighborCount[tile]; i++) {
+            int neighbor = geometry.neighbors[tile][i];
+            if (board.scrapAmount[neighbor] > 0 && !board.recycler[neighbor]) neighbors.tiles[neighbors.count++] = neighbor;
+        }
+        if (neighbors.count == 0) continue;
+
+        // One extra slot for the units that stay.
+        array<int, DIRECTION_COUNT + 1> moves{};
+        for (int i = 0; i < board.units[tile]; i++) {
+            moves[rng.below(neighbors.count + 1)]++;
+        }
+        for (int i = 0; i < neighbors.count; i++) {
+            if (moves[i] > 0) actions.push_back(Action::move(moves[i], geometry.coord(tile), geometry.coord(neighbors.tiles[i])));
+        }
+    }
+
+    for (int matter = state.matter[player]; matter >= BUILD_COST && spawnTileCount > 0; matter -= BUILD_COST) {
+        actions.push_back(Action::spawn(1, geometry.coord(spawnTiles[rng.below(spawnTileCount)])));
+    }
+}
+
+float evaluateState(const SimState &state) {
+    TileEvaluation evaluation;
+    tileEvaluator.evaluateBalances(state.board, evaluation);
+    int matter = state.matter[OWN_PLAYER] - state.matter[OPPONENT_PLAYER];
+    return evaluation.tileBalance + evaluation.totalUnitBalance * Settings::rolloutUnitWeight +
+           matter * Settings::rolloutMatterWeight;
+}
+
+RolloutEngine::RolloutEngine(ThreadPool &pool)
+    : pool(pool), depth(Settings::rolloutDepth), rolloutsPerTask(Settings::rolloutsPerTask),
+      budget(Settings::rolloutBudgetMicroseconds), workers(pool.workerCount()) {
+    for (auto &worker : workers) {
+        worker.ownPolicyActions.reserve(MAX_ACTIONS);
+        worker.opponentPolicyActions.reserve(MAX_ACTIONS);
+    }
+}
+
+int RolloutEngine::selectBest(const SimState &root, const vector<Actions> &candidates, uint32_t seed) {
+    PROFILE_ZONE("rollouts");
+    assert(!candidates.empty());
+    // Out of time: the first candidate is the plain heuristic and needs no playout to be trusted.
+    if (candidates.size() == 1 || TurnBudget::get().shouldStop()) return 0;
+
+    auto start = chrono::steady_clock::now();
+    totalScores.assign(candidates.size(), 0);
+    batchScores.assign(candidates.size(), 0);
+
+    // There is always at least one batch, so every candidate gets a score.
+    for (int batch = 0;; batch++) {
+        if (batch > 0 && (chrono::steady_clock::now() - start >= budget || TurnBudget::get().shouldStop())) break;
+
+        pool.parallelFor(candidates.size(), [&](int candidate, int workerIndex) {
+            Worker &worker = workers[workerIndex];
+            worker.rng.seed(seed ^ ((batch * candidates.size() + candidate + 1) * 0x9E3779B9u));
+            float score = 0;
+            for (int i = 0; i < rolloutsPerTask; i++) {
+                score += rollout(root, candidates[candidate], worker);
+            }
+            batchScores[candidate] = score;
+        });
+        for (int candidate = 0; candidate < static_cast<int>(candidates.size()); candidate++) {
+            totalScores[candidate] += batchScores[candidate];
+        }
+    }
+
+    // Every candidate ran the same number of playouts, so totals compare like averages.
+    return max_element(totalScores.begin(), totalScores.end()) - totalScores.begin();
+}
+
+float RolloutEngine::rollout(const SimState &root, const Actions &candidate, Worker &worker) {
+    SimState state = root;
+
+    randomPolicy(state, OPPONENT_PLAYER, worker.rng, worker.opponentPolicyActions);
+    simulateTurn(state, candidate, worker.opponentPolicyActions);
+    for (int turn = 1; turn < depth; turn++) {
+        randomPolicy(state, OWN_PLAYER, worker.rng, worker.ownPolicyActions);
+        randomPolicy(state, OPPONENT_PLAYER, worker.rng, worker.opponentPolicyActions);
+        simulateTurn(state, worker.ownPolicyActions, worker.opponentPolicyActions);
+    }
+
+    return evaluateState(state);
+}
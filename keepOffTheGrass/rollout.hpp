@@ -0,0 +1,42 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "../common/random.hpp"
+#include "../common/threadPool.hpp"
+#include "config.hpp"
+#include "actions.hpp"
+#include "simulator.hpp"
+#include "tileEvaluation.hpp"
+
+// Cheap playout policy: every unit steps to a random walkable neighbor or stays, spare matter spawns on random
+// tiles of the player.
+void randomPolicy(const SimState &state, int player, FastRandom &rng, Actions &actions);
+// Position value from our side: tile difference first, then units and matter.
+float evaluateState(const SimState &state);
+
+// Scores candidate action sets for our player with random playouts. Each batch runs rolloutsPerTask playouts of
+// every candidate on the pool, and batches repeat until the time budget runs out. Every task seeds its worker's
+// engine from (seed, batch, candidate) and batch results are summed in candidate order, so the outcome only depends
+// on the seed and the number of batches, never on thread scheduling.
+struct RolloutEngine {
+    struct Worker {
+        FastRandom rng;
+        Actions ownPolicyActions;
+        Actions opponentPolicyActions;
+    };
+
+    RolloutEngine(ThreadPool &pool);
+    int selectBest(const SimState &root, const vector<Actions> &candidates, uint32_t seed);
+    float rollout(const SimState &root, const Actions &candidate, Worker &worker);
+
+    ThreadPool &pool;
+    int depth;
+    int rolloutsPerTask;
+    chrono::microseconds budget;
+    vector<float> totalScores;
+    vector<float> batchScores;
+    vector<Worker> workers;
+};
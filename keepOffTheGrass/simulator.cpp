@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <cassert>
+
+#include "simulator.hpp"
+#include "boardKernels.hpp"
+
+namespace {
+    using PlayerTileArray = array<TileArray, PLAYER_COUNT>;
+
+    void applyBuilds(SimState &state, const Actions &actions, int player) {
+        Board &board = state.board;
+        for (const Action &action : actions) {
+            if (action.kind != ACTION::BUILD || state.matter[player] < BUILD_COST) continue;
+            int tile = geometry.index(action.pos);
+            if (board.owner[tile] != player || board.units[tile] > 0 || board.recycler[tile] || board.scrapAmount[tile] == 0) continue;
+
+            board.recycler[tile] = 1;
+            state.matter[player] -= BUILD_COST;
+        }
+    }
+
+    void applyMovesAndSpawns(SimState &state, const Actions &actions, int player, PlayerTileArray &units) {
+        Board &board = state.board;
+        TileArray &playerUnits = units[player];
+        // Units spawned this turn land after everybody moved, so they can't be moved again.
+        TileArray spawned{};
+
+        for (const Action &action : actions) {
+            if (action.kind == ACTION::MOVE) {
+                int from = geometry.index(action.pos);
+                int target = geometry.index(action.target);
+                if (board.owner[from] != player || from == target) continue;
+                int amount = min<int>(action.amount, board.units[from]);
+                if (amount <= 0) continue;
+                int next = getNextStepTile(board, from, target);
+                if (next == NO_TILE) continue;
+
+                board.units[from] -= amount;
+                playerUnits[from] -= amount;
+                playerUnits[next] += amount;
+            } else if (action.kind == ACTION::SPAWN) {
+                int tile = geometry.index(action.pos);
+                int amount = min(action.amount, state.matter[player] / BUILD_COST);
+                if (board.owner[tile] != player || board.recycler[tile] || board.scrapAmount[tile] == 0 || amount <= 0) continue;
+
+                state.matter[player] -= amount * BUILD_COST;
+                spawned[tile] += amount;
+            }
+        }
+
+        for (int tile = 0; tile < geometry.tileCount; tile++) {
+            playerUnits[tile] += spawned[tile];
+        }
+    }
+
+    void applyRecycling(SimState &state) {
+        Board &board = state.board;
+        array<bool, MAX_TILES> scrapped{};
+        for (int tile = 0; tile < geometry.tileCount; tile++) {
+            if (!board.recycler[tile]) continue;
+            int player = board.owner[tile];
+            auto harvest = [&](int scrapTile) {
+                if (board.scrapAmount[scrapTile] == 0) return;
+                state.matter[player]++;
+                scrapped[scrapTile] = true;
+            };
+            harvest(tile);
+            for (int i = 0; i < geometry.neighborCount[tile]; i++) {
+                harvest(geometry.neighbors[tile][i]);
+            }
+        }
+
+        // A tile next to several recyclers pays each of them but only loses one scrap.
+        for (int tile = 0; tile < geometry.tileCount; tile++) {
+            if (!scrapped[tile]) continue;
+            if (--board.scrapAmount[tile] == 0) {
+                board.owner[tile] = NO_OWNER;
+                board.units[tile] = 0;
+                board.recycler[tile] = 0;
+            }
+        }
+    }
+}
+
+void simulateTurn(SimState &state, const Actions &ownActions, const Actions &opponentActions) {
+    Board &board = state.board;
+
+    applyBuilds(state, ownActions, OWN_PLAYER);
+    applyBuilds(state, opponentActions, OPPONENT_PLAYER);
+
+    PlayerTileArray units{};
+    for (int tile = 0; tile < geometry.tileCount; tile++) {
+        if (board.units[tile] > 0) units[board.owner[tile]][tile] = board.units[tile];
+    }
+    applyMovesAndSpawns(state, ownActions, OWN_PLAYER, units);
+    applyMovesAndSpawns(state, opponentActions, OPPONENT_PLAYER, units);
+
+    for (int tile = 0; tile < geometry.tileCount; tile++) {
+        int own = units[OWN_PLAYER][tile];
+        int opponent = units[OPPONENT_PLAYER][tile];
+        int killed = min(own, opponent);
+        own -= killed;
+        opponent -= killed;
+
+        board.units[tile] = own + opponent;
+        if (own > 0) board.owner[tile] = OWN_PLAYER;
+        else if (opponent > 0) board.owner[tile] = OPPONENT_PLAYER;
+    }
+
+    applyRecycling(state);
+
+    for (int &matter : state.matter) {
+        matter += BASE_MATTER_INCOME;
+    }
+    refreshDerivedFlags(board);
+    state.turn++;
+}
+
+void refreshDerivedFlags(Board &board) {
+    boardKernels.refreshDerivedFlags(board);
+}
+
+// First tile on a shortest walkable path from 'from' to 'target', NO_TILE when the target can't be reached.
+int getNextStepTile(const Board &board, int from, int target) {
+    return boardKernels.nextStepTile(board, from, target);
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <array>
+#include <type_traits>
+
+#include "config.hpp"
+#include "board.hpp"
+#include "actions.hpp"
+
+// Everything the simulator needs about a position. Fixed size plain data so a rollout starts with one memcpy.
+struct SimState {
+    Board board;
+    array<int, PLAYER_COUNT> matter;
+    int turn;
+};
+static_assert(is_trivially_copyable<SimState>::value, "SimState must stay cheap to copy");
+
+// Plays one turn of Keep Off The Grass: builds, then moves and spawns together, combat, ownership, recycling and
+// grass removal, and finally income. Invalid actions are ignored the way the referee ignores them.
+void simulateTurn(SimState &state, const Actions &ownActions, const Actions &opponentActions);
+// Recomputes canBuild, canSpawn and willBeScrapped from the rest of the board.
+void refreshDerivedFlags(Board &board);
+int getNextStepTile(const Board &board, int from, int target);
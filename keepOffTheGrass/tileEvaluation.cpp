@@ -0,0 +1,202 @@
+#include <algorithm>
+
+#include "tileEvaluation.hpp"
+
+#if defined(__x86_64__) && !defined(SCALAR_EVALUATION)
+#include <immintrin.h>
+#define AVX2_EVALUATION
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+TileEvaluator tileEvaluator;
+TileEvaluation tileEvaluation;
+
+namespace {
+    // Neighbors above the first row and below the last one read zeros from a margin on each side of the planes.
+    constexpr int MARGIN = 16;
+    static_assert(MARGIN >= MAX_WIDTH && MARGIN % EVALUATION_LANES == 0, "A margin must cover a row and keep alignment");
+    constexpr int PLANE_SIZE = MARGIN + PADDED_TILES + MARGIN;
+
+    // The board as floats, tile t at MARGIN + t and zeros off the map.
+    struct Planes {
+        alignas(32) array<float, PLANE_SIZE> scrap;
+        // Recycler weight of the tile's owner.
+        alignas(32) array<float, PLANE_SIZE> scrapWeight;
+        // Own units positive, opponent units negative.
+        alignas(32) array<float, PLANE_SIZE> units;
+    };
+
+    const array<float, 3> &getScrapWeights() {
+        // Function static, so a tunable build reads the weights after loading them.
+        static const array<float, 3> scrapWeights = {Settings::freeTileScrapWeight, Settings::opponentTileScrapWeight,
+                                                     Settings::ownTileScrapWeight};
+        return scrapWeights;
+    }
+
+    // Without planes only the balances are summed, for the callers that need nothing else.
+    template <bool FILL_PLANES> void fillTile(const Board &board, int tile, Planes &planes, TileEvaluation &evaluation) {
+        int owner = board.owner[tile];
+        int sign = owner == OWN_PLAYER ? 1 : owner == OPPONENT_PLAYER ? -1 : 0;
+        if (FILL_PLANES) {
+            planes.scrap[MARGIN + tile] = board.scrapAmount[tile];
+            planes.scrapWeight[MARGIN + tile] = getScrapWeights()[owner + 1];
+            planes.units[MARGIN + tile] = sign * board.units[tile];
+        }
+        evaluation.tileBalance += sign;
+        evaluation.totalUnitBalance += sign * board.units[tile];
+    }
+
+    // Sums in the same order as the vector code, masked neighbors adding a zero, so both round alike.
+    void combineTile(const Planes &planes, int tile, bool hasLeft, bool hasRight, TileEvaluation &evaluation) {
+        int center = MARGIN + tile;
+        float scrap = planes.scrap[center];
+        auto harvest = [&](int index) { return min(planes.scrap[index], scrap) * planes.scrapWeight[index]; };
+        auto units = [&](int index) { return planes.units[index]; };
+
+        float yield = scrap * planes.scrapWeight[center];
+        yield += harvest(center - geometry.width);
+        yield += harvest(center + geometry.width);
+        yield += hasLeft ? harvest(center - 1) : 0.0f;
+        yield += hasRight ? harvest(center + 1) : 0.0f;
+        float reach = units(center) + units(center - geometry.width) + units(center + geometry.width) +
+                      (hasLeft ? units(center - 1) : 0.0f) + (hasRight ? units(center + 1) : 0.0f);
+
+        evaluation.recyclerYield[tile] = yield;
+        evaluation.frontierPressure[tile] = 0.0f - reach;
+        evaluation.unitBalance[tile] = units(center);
+    }
+
+#ifdef AVX2_EVALUATION
+    AVX2_TARGET __m256i loadTiles(const TileArray &values, int tile) {
+        return _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(&values[tile])));
+    }
+
+    // Fills whole vectors of tiles and returns where it stopped, the scalar code does the rest.
+    template <bool FILL_PLANES>
+    AVX2_TARGET int fillPlanesAvx2(const Board &board, Planes &planes, TileEvaluation &evaluation) {
+        const array<float, 3> &scrapWeights = getScrapWeights();
+        __m256 freeWeight = _mm256_set1_ps(scrapWeights[0]);
+        __m256 opponentWeight = _mm256_set1_ps(scrapWeights[OPPONENT_PLAYER + 1]);
+        __m256 ownWeight = _mm256_set1_ps(scrapWeights[OWN_PLAYER + 1]);
+        __m256i unitSums = _mm256_setzero_si256();
+        int end = geometry.tileCount / EVALUATION_LANES * EVALUATION_LANES;
+        for (int tile = 0; tile < end; tile += EVALUATION_LANES) {
+            __m256i owner = loadTiles(board.owner, tile);
+            __m256i own = _mm256_cmpeq_epi32(owner, _mm256_set1_epi32(OWN_PLAYER));
+            __m256i opponent = _mm256_cmpeq_epi32(owner, _mm256_set1_epi32(OPPONENT_PLAYER));
+            __m256i units = loadTiles(board.units, tile);
+            __m256i signedUnits = _mm256_sub_epi32(_mm256_and_si256(units, own), _mm256_and_si256(units, opponent));
+            __m256 weight = _mm256_blendv_ps(freeWeight, opponentWeight, _mm256_castsi256_ps(opponent));
+            weight = _mm256_blendv_ps(weight, ownWeight, _mm256_castsi256_ps(own));
+
+            if (FILL_PLANES) {
+                _mm256_store_ps(&planes.scrap[MARGIN + tile], _mm256_cvtepi32_ps(loadTiles(board.scrapAmount, tile)));
+                _mm256_store_ps(&planes.scrapWeight[MARGIN + tile], weight);
+                _mm256_store_ps(&planes.units[MARGIN + tile], _mm256_cvtepi32_ps(signedUnits));
+            }
+            unitSums = _mm256_add_epi32(unitSums, signedUnits);
+            evaluation.tileBalance += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(own))) -
+                                      __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(opponent)));
+        }
+
+        alignas(32) array<int32_t, EVALUATION_LANES> lanes;
+        _mm256_store_si256(reinterpret_cast<__m256i *>(lanes.data()), unitSums);
+        for (int lane : lanes) evaluation.totalUnitBalance += lane;
+        return end;
+    }
+
+    AVX2_TARGET void combineAvx2(const Planes &planes, const int32_t *onMap, const int32_t *hasLeft,
+                                 const int32_t *hasRight, TileEvaluation &evaluation) {
+        int width = geometry.width;
+        for (int tile = 0; tile < PADDED_TILES; tile += EVALUATION_LANES) {
+            const float *scrap = &planes.scrap[MARGIN + tile];
+            const float *scrapWeight = &planes.scrapWeight[MARGIN + tile];
+            const float *units = &planes.units[MARGIN + tile];
+            __m256 inMap = _mm256_load_ps(reinterpret_cast<const float *>(onMap + tile));
+            __m256 left = _mm256_load_ps(reinterpret_cast<const float *>(hasLeft + tile));
+            __m256 right = _mm256_load_ps(reinterpret_cast<const float *>(hasRight + tile));
+            __m256 centerScrap = _mm256_load_ps(scrap);
+
+            __m256 up = _mm256_mul_ps(_mm256_min_ps(_mm256_loadu_ps(scrap - width), centerScrap),
+                                      _mm256_loadu_ps(scrapWeight - width));
+            __m256 down = _mm256_mul_ps(_mm256_min_ps(_mm256_loadu_ps(scrap + width), centerScrap),
+                                        _mm256_loadu_ps(scrapWeight + width));
+            __m256 toLeft = _mm256_mul_ps(_mm256_min_ps(_mm256_loadu_ps(scrap - 1), centerScrap),
+                                          _mm256_loadu_ps(scrapWeight - 1));
+            __m256 toRight = _mm256_mul_ps(_mm256_min_ps(_mm256_loadu_ps(scrap + 1), centerScrap),
+                                           _mm256_loadu_ps(scrapWeight + 1));
+            __m256 yield = _mm256_mul_ps(centerScrap, _mm256_load_ps(scrapWeight));
+            yield = _mm256_add_ps(yield, up);
+            yield = _mm256_add_ps(yield, down);
+            yield = _mm256_add_ps(yield, _mm256_and_ps(left, toLeft));
+            yield = _mm256_add_ps(yield, _mm256_and_ps(right, toRight));
+
+            __m256 centerUnits = _mm256_load_ps(units);
+            __m256 reach = _mm256_add_ps(centerUnits, _mm256_loadu_ps(units - width));
+            reach = _mm256_add_ps(reach, _mm256_loadu_ps(units + width));
+            reach = _mm256_add_ps(reach, _mm256_and_ps(left, _mm256_loadu_ps(units - 1)));
+            reach = _mm256_add_ps(reach, _mm256_and_ps(right, _mm256_loadu_ps(units + 1)));
+
+            _mm256_store_ps(&evaluation.recyclerYield[tile], _mm256_and_ps(inMap, yield));
+            _mm256_store_ps(&evaluation.frontierPressure[tile],
+                            _mm256_and_ps(inMap, _mm256_sub_ps(_mm256_setzero_ps(), reach)));
+            _mm256_store_ps(&evaluation.unitBalance[tile], _mm256_and_ps(inMap, centerUnits));
+        }
+    }
+#endif
+}
+
+void TileEvaluator::resize() {
+    for (int tile = 0; tile < PADDED_TILES; tile++) {
+        bool inMap = tile < geometry.tileCount;
+        onMap[tile] = inMap ? -1 : 0;
+        hasLeft[tile] = inMap && geometry.tileX[tile] > 0 ? -1 : 0;
+        hasRight[tile] = inMap && geometry.tileX[tile] < geometry.width - 1 ? -1 : 0;
+    }
+#ifdef AVX2_EVALUATION
+    __builtin_cpu_init();
+    vectorized = __builtin_cpu_supports("avx2");
+#endif
+}
+
+void TileEvaluator::evaluate(const Board &board, TileEvaluation &evaluation) const {
+    Planes planes{};
+    evaluation.tileBalance = 0;
+    evaluation.totalUnitBalance = 0;
+
+    int tile = 0;
+#ifdef AVX2_EVALUATION
+    if (vectorized) tile = fillPlanesAvx2<true>(board, planes, evaluation);
+#endif
+    for (; tile < geometry.tileCount; tile++) {
+        fillTile<true>(board, tile, planes, evaluation);
+    }
+
+#ifdef AVX2_EVALUATION
+    if (vectorized) {
+        combineAvx2(planes, onMap.data(), hasLeft.data(), hasRight.data(), evaluation);
+        return;
+    }
+#endif
+    for (tile = 0; tile < geometry.tileCount; tile++) {
+        combineTile(planes, tile, hasLeft[tile], hasRight[tile], evaluation);
+    }
+    for (; tile < PADDED_TILES; tile++) {
+        evaluation.recyclerYield[tile] = evaluation.frontierPressure[tile] = evaluation.unitBalance[tile] = 0;
+    }
+}
+
+void TileEvaluator::evaluateBalances(const Board &board, TileEvaluation &evaluation) const {
+    // Never written nor read, the fill passes only need something to bind to.
+    static Planes unused;
+    evaluation.tileBalance = 0;
+    evaluation.totalUnitBalance = 0;
+
+    int tile = 0;
+#ifdef AVX2_EVALUATION
+    if (vectorized) tile = fillPlanesAvx2<false>(board, unused, evaluation);
+#endif
+    for (; tile < geometry.tileCount; tile++) {
+        fillTile<false>(board, tile, unused, evaluation);
+    }
+}
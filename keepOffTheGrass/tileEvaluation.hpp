@@ -0,0 +1,49 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "config.hpp"
+#include "board.hpp"
+
+// Tiles rounded up to whole vectors of 8 floats.
+constexpr int EVALUATION_LANES = 8;
+constexpr int PADDED_TILES = (MAX_TILES + EVALUATION_LANES - 1) / EVALUATION_LANES * EVALUATION_LANES;
+using FloatTileArray = array<float, PADDED_TILES>;
+
+// Per tile features of a whole board. Lanes past tileCount are zero.
+struct TileEvaluation {
+    // Scrap a recycler built on the tile would harvest, weighted by the owner of every harvested tile.
+    alignas(32) FloatTileArray recyclerYield;
+    // Opponent minus own units on the tile and its neighbors, the ones that can fight over it next turn.
+    alignas(32) FloatTileArray frontierPressure;
+    // Own minus opponent units on the tile.
+    alignas(32) FloatTileArray unitBalance;
+    // Own minus opponent tiles, and the sum of unitBalance.
+    int tileBalance;
+    int totalUnitBalance;
+};
+
+// Computes a TileEvaluation for all tiles at once from the Board arrays, with AVX2 when the CPU has it and a
+// scalar loop otherwise. Both give the same values, so a match plays the same on either.
+class TileEvaluator {
+public:
+    // Call after geometry is resized.
+    void resize();
+    void evaluate(const Board &board, TileEvaluation &evaluation) const;
+    // Only tileBalance and totalUnitBalance, skipping the per tile planes. For the rollout leaves.
+    void evaluateBalances(const Board &board, TileEvaluation &evaluation) const;
+
+    // Set by resize() from what the CPU supports, the bench turns it off to compare.
+    bool vectorized = false;
+
+private:
+    // All bits set where the tile is on the map and has a neighbor to its left or right.
+    alignas(32) array<int32_t, PADDED_TILES> onMap;
+    alignas(32) array<int32_t, PADDED_TILES> hasLeft;
+    alignas(32) array<int32_t, PADDED_TILES> hasRight;
+};
+
+extern TileEvaluator tileEvaluator;
+// Features of the current board, refreshed in updateGameStatus().
+extern TileEvaluation tileEvaluation;
@@ -0,0 +1,12 @@
+#pragma once
+
+// Hand-picked before there was a tuner. `make tune` overwrites this file once it finds values that beat these.
+namespace Tuned {
+    const int freeTileWeight = 4;
+    const int opponentTileWeight = 32;
+    const int ownTileWeight = 2;
+    const float freeTileScrapWeight = 1.0f;
+    const float opponentTileScrapWeight = 1.5f;
+    const float ownTileScrapWeight = -1.0f;
+    const int tilesPerTower = 20;
+}
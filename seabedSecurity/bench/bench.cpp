@@ -0,0 +1,94 @@
+#include "../../common/bench.hpp"
+#include "../creatureTracker.hpp"
+#include "../droneBehaviors.hpp"
+#include "../routePlanner.hpp"
+#include "../simulator.hpp"
+#include "../states.hpp"
+#include "../sweep.hpp"
+
+namespace {
+    string turnInput;
+    GameState state;
+
+    // Parses the fixture once so every benchmark starts from the same state.
+    void setUp() {
+        static bool done = false;
+        if (done) return;
+        done = true;
+
+        turnInput = loadFixture("bench/fixture.log");
+        // The config part of the fixture: the creature count line and one line per creature.
+        int configLines = 1 + stoi(turnInput.substr(0, turnInput.find('\n')));
+        InputReader configInput(takeLines(turnInput, configLines));
+        GameConfig::get().parseInput(configInput);
+        InputReader in(turnInput);
+        state.parseInput(in);
+        state.own.calculateRemainingCreatures();
+        CreatureTracker::get().update(state);
+        RoutePlanner::get().plan(state, CreatureTracker::get());
+    }
+}
+
+BENCHMARK(parseInput) {
+    setUp();
+    for (long i = 0; i < iterations; i++) {
+        GameState parsed;
+        InputReader in(turnInput);
+        parsed.parseInput(in);
+        doNotOptimize(parsed);
+    }
+}
+
+BENCHMARK(calculateRemainingCreatures) {
+    setUp();
+    for (long i = 0; i < iterations; i++) {
+        state.own.calculateRemainingCreatures();
+        doNotOptimize(state.own.remainingCreatures);
+    }
+}
+
+BENCHMARK(findNextTargetForDrone) {
+    setUp();
+    for (long i = 0; i < iterations; i++) {
+        const DroneState &drone = state.own.drones[i % state.own.drones.size()];
+        doNotOptimize(findNextTargetForDrone(drone, state.own, state.visibleEnemies, RoutePlanner::get()));
+    }
+}
+
+BENCHMARK(cleanupDirection) {
+    setUp();
+    for (long i = 0; i < iterations; i++) {
+        const DroneState &drone = state.own.drones[i % state.own.drones.size()];
+        Quadrant quadrant = QUADRANTS[i % QUADRANTS.size()];
+        Coord target = getQuadrantCenter(quadrant, drone.position);
+        doNotOptimize(cleanupDirection(drone.position, target, state.visibleEnemies));
+    }
+}
+
+BENCHMARK(simulateTick) {
+    setUp();
+    SimState initial = SimState::fromGame(state);
+    DroneCommands commands{};
+    for (long i = 0; i < iterations; i++) {
+        SimState sim = initial;
+        simulateTick(sim, commands);
+        doNotOptimize(sim);
+    }
+}
+
+BENCHMARK(headingSweep) {
+    setUp();
+    HeadingSearch search(SAFE_HEADINGS, DRONE_MOVE_SPEED);
+    MonsterSweep monsters;
+    monsters.load(state.visibleEnemies);
+    array<bool, MAX_HEADINGS> safe;
+    for (long i = 0; i < iterations; i++) {
+        const DroneState &drone = state.own.drones[i % state.own.drones.size()];
+        search.sweep(drone.position, monsters, MONSTER_KILL_RADIUS, safe);
+        doNotOptimize(safe);
+    }
+}
+
+int main(int argc, char **argv) {
+    return runBenchmarks(argc, argv);
+}
@@ -1,17 +1,16 @@
-#include <algorithm>
 #include <cassert>
-#include <vector>
+#include <cstring>
 
 #include "config.hpp"
 
-Quadrant getQuadrant(string str) {
-    if (str.compare("TL") == 0)
+Quadrant getQuadrant(const char *str) {
+    if (strcmp(str, "TL") == 0)
         return Quadrant::TL;
-    if (str.compare("TR") == 0)
+    if (strcmp(str, "TR") == 0)
         return Quadrant::TR;
-    if (str.compare("BL") == 0)
+    if (strcmp(str, "BL") == 0)
         return Quadrant::BL;
-    if (str.compare("BR") == 0)
+    if (strcmp(str, "BR") == 0)
         return Quadrant::BR;
 
     assert(false);
@@ -31,8 +30,13 @@ string getName(Quadrant quadrant) {
 }
 
 IntSet filterSet(const IntSet &filter, const IntSet &set) {
-    vector<int> inVector(set.begin(), set.end());
-    vector<int> filteredVector;
-    copy_if(inVector.begin(), inVector.end(), filteredVector.begin(), [&filter](auto& elem) { return filter.count(elem) != 1; });
-    return IntSet(filteredVector.begin(), filteredVector.end());
+    return set - filter;
 }
+
+#ifdef TUNABLE
+TUNED_PARAMETERS(DEFINE_PARAMETER)
+
+void loadParameters(const char *path) {
+    readParameters(path, {TUNED_PARAMETERS(PARAMETER_BINDING)});
+}
+#endif
@@ -1,23 +1,46 @@
 #pragma once
 
-#include <set>
-#include <map>
+#include <array>
 #include <string>
 
+#include "../common/parameters.hpp"
+#include "../common/profiler.hpp"
+#include "idSet.hpp"
+#include "tunedParameters.hpp"
+
 using namespace std;
 
-const int AVOID_DISTANCE = 1200;
-const int FLEE_DISTANCE = 800;
-const int DARK_DISTANCE = 2000;
-const float DRIFT_RATIO = 0.1f;
+// Searched by `make tune`, see parameters.hpp.
+#define TUNED_PARAMETERS(PARAMETER)                                                                                    \
+    PARAMETER(int, AVOID_DISTANCE, Tuned::AVOID_DISTANCE, 500, 3000)                                                   \
+    PARAMETER(int, FLEE_DISTANCE, Tuned::FLEE_DISTANCE, 300, 2000)                                                     \
+    PARAMETER(int, DARK_DISTANCE, Tuned::DARK_DISTANCE, 800, 4000)                                                     \
+    PARAMETER(float, DRIFT_RATIO, Tuned::DRIFT_RATIO, 0, 0.5)
+
+TUNED_PARAMETERS(DECLARE_PARAMETER)
+#ifdef TUNABLE
+void loadParameters(const char *path);
+#endif
 const int MAX_SCANS = 6;
+// How many ticks a drone simulates its move ahead before committing to it.
+const int LOOKAHEAD_TURNS = 4;
+const int SAFE_HEADINGS = 72;
+// Route planning: annealing time per turn, and how much a scan loses for every turn it waits to be saved.
+const int ROUTE_BUDGET_MICROSECONDS = 5000;
+const double ROUTE_TURN_DISCOUNT = 0.97;
+// Below this much time left drones skip the lookahead and trust their plain heuristics.
+const int LOOKAHEAD_RESERVE_MICROSECONDS = 2000;
+#ifdef OFFLINE_EVAL
+// Offline analysis scores target choices on as many workers as `make offline-tournament` asks for.
+const int EVALUATION_THREADS = OFFLINE_EVAL;
+#else
+const int EVALUATION_THREADS = 1;
+#endif
 
 #define FORN(VAR, LIMIT) for (int VAR = 0; VAR < LIMIT; VAR++)
 #define FORI(LIMIT) FORN(i, LIMIT)
 #define assertm(exp, msg) assert(((void)msg, exp))
 
-using IntSet = set<int>;
-
 enum class Color : int { ENEMY = -1, PINK, YELLOW, GREEN, BLUE };
 
 enum class Type : int { ENEMY = -1, OCTUPUS, FISH, CRAB };
@@ -25,9 +48,20 @@ enum class Type : int { ENEMY = -1, OCTUPUS, FISH, CRAB };
 enum class TargetType { NONE, CREATURE, QUADRANT };
 
 enum class Quadrant : int { TL, TR, BL, BR };
-using RadarMap = map<Quadrant, IntSet>;
+const int QUADRANT_COUNT = 4;
+const array<Quadrant, QUADRANT_COUNT> QUADRANTS{Quadrant::TL, Quadrant::TR, Quadrant::BL, Quadrant::BR};
+
+// Radar blips seen by a drone, one id set per quadrant.
+struct RadarMap {
+    IntSet &operator[](Quadrant quadrant) { return slots[static_cast<int>(quadrant)]; }
+    const IntSet &operator[](Quadrant quadrant) const { return slots[static_cast<int>(quadrant)]; }
+    void clear() { slots.fill(IntSet{}); }
+    IntSet all() const { return slots[0] | slots[1] | slots[2] | slots[3]; }
+
+    array<IntSet, QUADRANT_COUNT> slots;
+};
 
 string getName(Quadrant quadrant);
-Quadrant getQuadrant(string str);
+Quadrant getQuadrant(const char *str);
 IntSet filterSet(const IntSet &filter, const IntSet &set);
 
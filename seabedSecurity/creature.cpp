@@ -1,15 +1,12 @@
 #include "creature.hpp"
 
-CreatureStateSet getCreaturesInQuadrant(Quadrant quadrant, Coord quadrantCenter, CreatureStateSet &creatures) {
-    CreatureStateSet enemies;
-    for (auto &enemy : creatures)
-        if (isPositionInQuadrant(enemy.position, quadrant, quadrantCenter))
-            enemies.insert(enemy);
-
-    return enemies;
+CreatureStateSet getCreaturesInQuadrant(Quadrant quadrant, Coord quadrantCenter, const CreatureStateSet &creatures) {
+    return creatures.filter([&](const CreatureState &creature) {
+        return isPositionInQuadrant(creature.position, quadrant, quadrantCenter);
+    });
 }
 
-bool isAnyCreatureInRange(CreatureStateSet creatures, Coord position, int range) {
+bool isAnyCreatureInRange(const CreatureStateSet &creatures, Coord position, int range) {
     for (auto &creature : creatures)
         if (getSqDistance(creature.position + creature.velocity, position) < range * range)
             return true;
@@ -0,0 +1,126 @@
+#include <algorithm>
+
+#include "creatureTracker.hpp"
+#include "drone.hpp"
+#include "simulator.hpp"
+
+/****** Box ******/
+Box Box::habitat(Type type) {
+    return Box{0, getHabitatTop(type), MAP_SIZE - 1, getHabitatBottom(type)};
+}
+
+bool Box::empty() const {
+    return minX > maxX || minY > maxY;
+}
+
+Coord Box::center() const {
+    return Coord{(minX + maxX) / 2, (minY + maxY) / 2};
+}
+
+Box Box::intersect(const Box &other) const {
+    return Box{max(minX, other.minX), max(minY, other.minY), min(maxX, other.maxX), min(maxY, other.maxY)};
+}
+
+Box Box::expand(int distance) const {
+    return Box{minX - distance, minY - distance, maxX + distance, maxY + distance};
+}
+
+Box Box::shift(Coord offset) const {
+    return Box{minX + offset.x, minY + offset.y, maxX + offset.x, maxY + offset.y};
+}
+
+/****** CreatureTracker ******/
+CreatureTracker& CreatureTracker::get() {
+    static CreatureTracker creatureTracker;
+    return creatureTracker;
+}
+
+void CreatureTracker::update(const GameState &game) {
+    PROFILE_ZONE("tracker");
+    const GameConfig &config = GameConfig::get();
+
+    IntSet present;
+    for (const DroneState &drone : game.own.drones)
+        present |= drone.bleeps.all();
+
+    for (int id : present) {
+        Type type = config.creatures.count(id) ? config.creatures.at(id).type : Type::ENEMY;
+        Box habitat = Box::habitat(type);
+
+        Box box;
+        if (game.visibleCreatures.count(id) || game.visibleEnemies.count(id)) {
+            const CreatureState &seen =
+                game.visibleCreatures.count(id) ? game.visibleCreatures.at(id) : game.visibleEnemies.at(id);
+            box = Box{seen.position.x, seen.position.y, seen.position.x, seen.position.y};
+            velocities[id] = seen.velocity;
+        } else if (tracked.count(id)) {
+            // Growing by the top speed around the drifted box covers any change of course short of turning back.
+            box = boxes[id]
+                      .shift(velocities[id])
+                      .expand(type == Type::ENEMY ? MONSTER_CHASE_SPEED : FISH_FLEE_SPEED)
+                      .intersect(habitat);
+        } else {
+            box = habitat;
+            velocities[id] = Coord{0, 0};
+        }
+
+        Box radar = habitat;
+        for (const DroneState &drone : game.own.drones) {
+            for (Quadrant quadrant : QUADRANTS) {
+                if (drone.bleeps[quadrant].count(id))
+                    radar = radar.intersect(getRadarBox(drone.position, quadrant));
+            }
+        }
+
+        // Rounding in the referee, an unseen bounce or a turn back can leave nothing, the radar alone is then the best
+        // guess and the velocity is no longer trusted.
+        box = box.intersect(radar);
+        if (box.empty()) {
+            box = radar;
+            velocities[id] = Coord{0, 0};
+        }
+        boxes[id] = box;
+    }
+
+    tracked = present;
+}
+
+bool CreatureTracker::isTracked(int creatureId) const {
+    return tracked.count(creatureId);
+}
+
+const Box &CreatureTracker::getBox(int creatureId) const {
+    return boxes[creatureId];
+}
+
+Coord CreatureTracker::getEstimate(int creatureId) const {
+    return boxes[creatureId].center();
+}
+
+/****** Utility functions ******/
+Box getRadarBox(Coord position, Quadrant quadrant) {
+    Box box{0, 0, MAP_SIZE - 1, MAP_SIZE - 1};
+    switch (quadrant) {
+    case Quadrant::TL:
+    case Quadrant::TR:
+        box.maxY = position.y;
+        break;
+    case Quadrant::BL:
+    case Quadrant::BR:
+        box.minY = position.y;
+        break;
+    }
+
+    switch (quadrant) {
+    case Quadrant::TL:
+    case Quadrant::BL:
+        box.maxX = position.x;
+        break;
+    case Quadrant::TR:
+    case Quadrant::BR:
+        box.minX = position.x;
+        break;
+    }
+
+    return box;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <array>
+
+#include "config.hpp"
+#include "coord.hpp"
+#include "states.hpp"
+
+// Axis aligned region, bounds included.
+struct Box {
+    static Box habitat(Type type);
+
+    bool empty() const;
+    Coord center() const;
+    Box intersect(const Box &other) const;
+    Box expand(int distance) const;
+    Box shift(Coord offset) const;
+
+    int minX;
+    int minY;
+    int maxX;
+    int maxY;
+};
+
+// Where every creature still in the game may be. A creature's box collapses to a point while it is seen. Out of the
+// light it drifts by the last seen velocity and grows by the creature's top speed each turn, then is cut down to the
+// quadrant every own drone's radar reports it in and to its habitat.
+struct CreatureTracker {
+    static CreatureTracker& get();
+    void update(const GameState &game);
+    bool isTracked(int creatureId) const;
+    const Box &getBox(int creatureId) const;
+    Coord getEstimate(int creatureId) const;
+
+    IntSet tracked;
+    array<Box, MAX_ENTITY_ID> boxes;
+    // Last seen velocity, zero once the radar contradicts it.
+    array<Coord, MAX_ENTITY_ID> velocities;
+};
+
+Box getRadarBox(Coord dronePosition, Quadrant quadrant);
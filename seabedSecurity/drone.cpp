@@ -1,26 +1,20 @@
-#include <memory>
 #include <iostream>
 
+#include "creatureTracker.hpp"
 #include "drone.hpp"
 #include "droneBehaviors.hpp"
 #include "states.hpp"
-
-DroneBehavior::DroneBehavior(DroneState &drone) : drone(drone) {
-}
+#include "routePlanner.hpp"
+#include "targetChoices.hpp"
 
 DroneState::DroneState(int droneId) : id(droneId) {
-    currentBehavior = make_unique<DBSurfacing>(*this);
-}
-
-DroneState::DroneState(const DroneState &other)
-    : id(other.id), position(other.position), emergency(other.emergency), battery(other.battery),
-      currentScans(other.currentScans), bleeps(other.bleeps) {
-    currentBehavior = other.currentBehavior->getCopy(*this);
 }
 
-void DroneState::parseInput(istream &in) {
-    in >> position.x >> position.y >> emergency >> battery;
-    in.ignore();
+void DroneState::parseInput(InputReader &in) {
+    position.x = in.readInt();
+    position.y = in.readInt();
+    emergency = in.readInt();
+    battery = in.readInt();
 
     currentScans.clear();
     bleeps.clear();
@@ -34,10 +28,20 @@ void DroneState::move(Coord position, bool useLight, string message) {
     cout << "MOVE " << position.x << " " << position.y << " " << (useLight ? "1" : "0") << " " << message << endl;
 }
 
-void DroneState::runAllOwnDrones() {
-    GameState &state = GameState::get();
+void DroneState::runAllOwnDrones(GameState &state) {
+    CreatureTracker &tracker = CreatureTracker::get();
+    RoutePlanner &routes = RoutePlanner::get();
+    TargetChoices &choices = TargetChoices::get();
+    tracker.update(state);
+    routes.plan(state, tracker);
+    choices.evaluate(state.own, state.visibleEnemies);
+    TurnContext context{tracker, routes, choices};
     for (auto &drone : state.own.drones) {
-        drone.currentBehavior->TryChange();
-        drone.currentBehavior->Process();
+        PROFILE_ZONE("drone");
+        optional<DroneBehavior> next =
+            visit([&](auto &behavior) { return behavior.TryChange(drone, state, context); }, drone.behavior);
+        if (next.has_value())
+            drone.behavior = next.value();
+        visit([&](const auto &behavior) { behavior.Process(drone, state, context); }, drone.behavior);
     }
 }
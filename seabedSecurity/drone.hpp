@@ -1,32 +1,20 @@
 #pragma once
 
 #include <istream>
-#include <memory>
 
+#include "../common/inputReader.hpp"
 #include "config.hpp"
-#include "states.hpp"
+#include "droneBehaviors.hpp"
+#include "fixedVector.hpp"
 
-struct GameConfig;
-struct GameState;
-struct DroneState;
-
-struct DroneBehavior {
-    DroneBehavior(DroneState &drone);
-    virtual void TryChange() = 0;
-    virtual void Process() = 0;
-    virtual ~DroneBehavior() = default;
-    virtual unique_ptr<DroneBehavior> getCopy(DroneState &drone) const = 0;
-
-    DroneState &drone;
-};
+const int MAX_PLAYER_DRONES = 2;
 
 struct DroneState {
-    DroneState(int droneId);
-    DroneState(const DroneState &other);
-    void parseInput(istream& in);
+    DroneState(int droneId = -1);
+    void parseInput(InputReader& in);
     void wait(bool useLight, string message);
     void move(Coord position, bool useLight, string message);
-    static void runAllOwnDrones();
+    static void runAllOwnDrones(GameState &game);
 
     int id;
     Coord position;
@@ -34,8 +22,8 @@ struct DroneState {
     int battery;
     IntSet currentScans;
     RadarMap bleeps;
-    unique_ptr<DroneBehavior> currentBehavior;
+    DroneBehavior behavior;
 };
-using DroneStateVec = vector<DroneState>;
+using DroneStateVec = FixedVector<DroneState, MAX_PLAYER_DRONES>;
 
 
@@ -1,73 +1,61 @@
+#include <algorithm>
 #include <optional>
 #include <sstream>
 #include <iostream>
 
+#include "../common/turnBudget.hpp"
+#include "creatureTracker.hpp"
+#include "drone.hpp"
 #include "droneBehaviors.hpp"
+#include "simulator.hpp"
+#include "sweep.hpp"
+#include "routePlanner.hpp"
 #include "states.hpp"
+#include "targetChoices.hpp"
 
 /****** DBSurfacing ******/
-DBSurfacing::DBSurfacing(DroneState &drone) : DroneBehavior(drone) {
-}
-
-unique_ptr<DroneBehavior> DBSurfacing::getCopy(DroneState &drone) const {
-    DroneBehavior *newBehavior = new DBSurfacing(drone);
-    return unique_ptr<DroneBehavior>(newBehavior);
-}
-
-void DBSurfacing::TryChange() {
-    GameState& game = GameState::get();
-
-    unique_ptr<DroneBehavior> buffer;
+optional<DroneBehavior> DBSurfacing::TryChange(const DroneState &drone, const GameState &game,
+                                               const TurnContext &context) const {
     if (drone.position.y <= 500) {
-        optional<Quadrant> quadrant = findNextTargetForDrone(drone, game.own, game.visibleEnemies);
-        if (quadrant.has_value()) {
-            buffer = std::move(drone.currentBehavior);
-            drone.currentBehavior = unique_ptr<DroneBehavior>(new DBSearching(drone, quadrant.value()));
-        }
+        optional<Quadrant> quadrant = chooseTargetForDrone(drone, game, context);
+        if (quadrant.has_value())
+            return DBSearching{quadrant.value()};
     }
+    return {};
 }
 
-void DBSurfacing::Process() {
-    bool useLight = !isAnyCreatureInRange(GameState::get().visibleEnemies, drone.position, DARK_DISTANCE);
+void DBSurfacing::Process(DroneState &drone, const GameState &game, const TurnContext &) const {
+    bool useLight = !isAnyCreatureInRange(game.visibleEnemies, drone.position, DARK_DISTANCE);
     drone.move(Coord{drone.position.x, 0}, useLight, "Surfacing");
 }
 
 /****** DBSearching ******/
-DBSearching::DBSearching(DroneState &drone, Quadrant quadrant) : DroneBehavior(drone) {
-    currentTarget = quadrant;
-}
-
-unique_ptr<DroneBehavior> DBSearching::getCopy(DroneState &drone) const {
-    DroneBehavior *newBehavior = new DBSearching(drone, currentTarget);
-    return unique_ptr<DroneBehavior>(newBehavior);
-} 
-
-void DBSearching::TryChange() {
-    GameState& game = GameState::get();
-
-    if (drone.currentScans.size() >= MAX_SCANS) {
-        drone.currentBehavior = unique_ptr<DroneBehavior>(new DBSurfacing(drone));
-        return;
-    }
-
-    optional<Quadrant> quadrant = findNextTargetForDrone(drone, game.own, game.visibleEnemies);
-    if (!quadrant.has_value()) {
-        drone.currentBehavior = unique_ptr<DroneBehavior>(new DBSurfacing(drone));
-    } else {
-        currentTarget = quadrant.value();
-    }
+optional<DroneBehavior> DBSearching::TryChange(const DroneState &drone, const GameState &game,
+                                               const TurnContext &context) {
+    if (drone.currentScans.size() >= MAX_SCANS)
+        return DBSurfacing{};
+
+    optional<Quadrant> quadrant = chooseTargetForDrone(drone, game, context);
+    if (!quadrant.has_value())
+        return DBSurfacing{};
+    currentTarget = quadrant.value();
+    return {};
 }
 
-void DBSearching::Process() {
-    GameState& game = GameState::get();
-
+void DBSearching::Process(DroneState &drone, const GameState &game, const TurnContext &context) const {
     bool useLight = !isAnyCreatureInRange(game.visibleEnemies, drone.position, DARK_DISTANCE);
     Quadrant quadrant = static_cast<Quadrant>(currentTarget);
-    Coord target = getQuadrantCenter(quadrant, drone.position);
-    CreatureStateSet creaturesInQuadrant = getCreaturesInQuadrant(quadrant, drone.position, game.visibleEnemies);
+    Coord target = getLikelyTarget(drone, quadrant, game.own, context);
     if (isAnyCreatureInRange(game.visibleEnemies, drone.position, AVOID_DISTANCE)) {
         target = cleanupDirection(drone.position, target, game.visibleEnemies);
     }
+    // Simulating ahead is the first thing to go when the turn runs late, cleanupDirection still steers clear.
+    if (TurnBudget::get().timeLeft() > LOOKAHEAD_RESERVE_MICROSECONDS) {
+        SimState sim = SimState::fromGame(game);
+        int simIndex = sim.findDrone(drone.id);
+        if (simIndex >= 0 && !isCommandSafe(sim, simIndex, DroneCommand::move(target, useLight), LOOKAHEAD_TURNS))
+            target = findSafeTarget(sim, simIndex, target, useLight);
+    }
     stringstream message;
     if (abs(static_cast<float>(target.x) / target.y) < DRIFT_RATIO) {
         message << "Drifting " << getName(quadrant);
@@ -79,26 +67,23 @@ void DBSearching::Process() {
 }
 
 /****** Utility functions ******/
-optional<Quadrant> findNextTargetForDrone(const DroneState &drone, PlayerState &state,
-                                          CreatureStateSet &visibleEnemies) {
+optional<Quadrant> findNextTargetForDrone(const DroneState &drone, const PlayerState &state,
+                                          const CreatureStateSet &visibleEnemies, const RoutePlanner &routes) {
     if (state.remainingCreatures.size() == 0) {
         cerr << "No remaining creatures for " << drone.id << endl;
         return {};
     }
 
-    int nextCreature = *state.remainingCreatures.begin();
-    for (int creatureId : state.remainingCreatures) {
-        if (creatureId % 2 == drone.id / 2) {
-            nextCreature = creatureId;
-            break;
-        }
-    }
+    optional<int> planned = routes.getNextCreature(drone.id);
+    if (!planned.has_value())
+        return {};
+    int nextCreature = planned.value();
 
     cerr << drone.id << " goes for " << nextCreature << endl;
 
-    for (auto bleep : drone.bleeps) {
-        if (bleep.second.count(nextCreature)) {
-            return bleep.first;
+    for (Quadrant quadrant : QUADRANTS) {
+        if (drone.bleeps[quadrant].count(nextCreature)) {
+            return quadrant;
         }
     }
 
@@ -106,25 +91,19 @@ optional<Quadrant> findNextTargetForDrone(const DroneState &drone, PlayerState &
     return {};
 }
 
-optional<Quadrant> findNewTargetsByRadar(const DroneState &drone, PlayerState &state,
-                                         CreatureStateSet &visibleEnemies) {
+optional<Quadrant> findNewTargetsByRadar(const DroneState &drone, const PlayerState &state,
+                                         const CreatureStateSet &visibleEnemies) {
     if (isAnyCreatureInRange(visibleEnemies, drone.position, FLEE_DISTANCE))
         return {};
 
     Quadrant maxDensityQuadrant;
     double maxDensity = 0;
-    for (auto &quadrant : drone.bleeps) {
-        if (isAnyCreatureInRange(getCreaturesInQuadrant(quadrant.first, drone.position, visibleEnemies), drone.position,
-                                 AVOID_DISTANCE)) {
-            cerr << "Avoiding quadrant " << getName(quadrant.first) << " for " << drone.id << endl;
-            continue;
-        }
-        IntSet remainingInQuadrant = filterSet(state.remainingCreatures, quadrant.second);
-        double density = getDensity(drone.position, quadrant.first, remainingInQuadrant.size());
-        cerr << "For drone " << drone.id << " density in " << getName(quadrant.first) << " is " << density << endl;
+    for (Quadrant quadrant : QUADRANTS) {
+        double density = scoreTargetChoice(drone, quadrant, state, visibleEnemies);
+        cerr << "For drone " << drone.id << " density in " << getName(quadrant) << " is " << density << endl;
         if (maxDensity < density) {
             maxDensity = density;
-            maxDensityQuadrant = quadrant.first;
+            maxDensityQuadrant = quadrant;
         }
     }
 
@@ -133,7 +112,49 @@ optional<Quadrant> findNewTargetsByRadar(const DroneState &drone, PlayerState &s
     return {};
 }
 
-Coord cleanupDirection(Coord position, Coord target, CreatureStateSet creatures) {
+optional<Quadrant> chooseTargetForDrone(const DroneState &drone, const GameState &game, const TurnContext &context) {
+    optional<Quadrant> quadrant = findNextTargetForDrone(drone, game.own, game.visibleEnemies, context.routes);
+    if (quadrant.has_value() || context.routes.isSurfacing(drone.id))
+        return quadrant;
+    return context.choices.getBest(drone.id);
+}
+
+// Density of still unscanned creatures the drone's radar sees in the quadrant, 0 when an enemy there is too close.
+double scoreTargetChoice(const DroneState &drone, Quadrant quadrant, const PlayerState &state,
+                         const CreatureStateSet &visibleEnemies) {
+    if (isAnyCreatureInRange(getCreaturesInQuadrant(quadrant, drone.position, visibleEnemies), drone.position,
+                             AVOID_DISTANCE))
+        return 0;
+
+    int remainingInQuadrant = (drone.bleeps[quadrant] & state.remainingCreatures).size();
+    return getDensity(drone.position, quadrant, remainingInQuadrant);
+}
+
+// Estimated position of the creature the route planner sends the drone to, else of the closest still unscanned
+// creature the radar shows in the quadrant, else the quadrant center.
+Coord getLikelyTarget(const DroneState &drone, Quadrant quadrant, const PlayerState &state,
+                      const TurnContext &context) {
+    const CreatureTracker &tracker = context.tracker;
+    optional<int> planned = context.routes.getNextCreature(drone.id);
+    if (planned.has_value() && drone.bleeps[quadrant].count(planned.value()) && tracker.isTracked(planned.value()))
+        return tracker.getEstimate(planned.value());
+
+    Coord target = getQuadrantCenter(quadrant, drone.position);
+    int targetDistance = -1;
+    for (int creatureId : drone.bleeps[quadrant] & state.remainingCreatures) {
+        if (!tracker.isTracked(creatureId))
+            continue;
+        Coord estimate = tracker.getEstimate(creatureId);
+        int distance = getSqDistance(drone.position, estimate);
+        if (targetDistance < 0 || distance < targetDistance) {
+            target = estimate;
+            targetDistance = distance;
+        }
+    }
+    return target;
+}
+
+Coord cleanupDirection(Coord position, Coord target, const CreatureStateSet &creatures) {
     Coord ret;
     bool positiveX = target.x - position.x > 0;
     bool positiveY = target.y - position.y > 0;
@@ -166,3 +187,29 @@ Coord cleanupDirection(Coord position, Coord target, CreatureStateSet creatures)
     }
 }
 
+
+// Among SAFE_HEADINGS full speed moves that clear every monster this tick, the one closest to target that also
+// survives LOOKAHEAD_TURNS simulated ticks. Falls back to target when every heading runs into a monster.
+Coord findSafeTarget(const SimState &sim, int droneIndex, Coord target, bool useLight) {
+    static const HeadingSearch search(SAFE_HEADINGS, DRONE_MOVE_SPEED);
+    Coord position = sim.drones[droneIndex].position;
+    MonsterSweep monsters;
+    FORN(m, sim.monsterCount)
+        monsters.add(sim.monsters[m].position, sim.monsters[m].velocity);
+    array<bool, MAX_HEADINGS> safe;
+    search.sweep(position, monsters, MONSTER_KILL_RADIUS, safe);
+
+    array<pair<int, int>, MAX_HEADINGS> candidates;
+    int candidateCount = 0;
+    FORI(search.headingCount) {
+        if (safe[i])
+            candidates[candidateCount++] = {getSqDistance(search.heading(position, i), target), i};
+    }
+    sort(candidates.begin(), candidates.begin() + candidateCount);
+    FORI(candidateCount) {
+        Coord heading = search.heading(position, candidates[i].second);
+        if (isCommandSafe(sim, droneIndex, DroneCommand::move(heading, useLight), LOOKAHEAD_TURNS))
+            return heading;
+    }
+    return candidateCount > 0 ? search.heading(position, candidates[0].second) : target;
+}
@@ -1,28 +1,54 @@
 #pragma once
 
 #include <optional>
+#include <variant>
 
 #include "config.hpp"
-#include "drone.hpp"
+#include "coord.hpp"
+#include "creature.hpp"
 
-struct DBSurfacing : DroneBehavior {
-    DBSurfacing(DroneState &drone);
-    virtual unique_ptr<DroneBehavior> getCopy(DroneState &drone) const override;
-    virtual void TryChange() override;
-    virtual void Process() override;
+struct DroneState;
+struct PlayerState;
+struct GameState;
+struct SimState;
+struct CreatureTracker;
+struct RoutePlanner;
+struct TargetChoices;
+struct DBSurfacing;
+struct DBSearching;
+
+// What the bot worked out from a GameState this turn. Behaviors get it next to the state they run on rather than
+// reading the analysis of the real turn from its singletons.
+struct TurnContext {
+    const CreatureTracker &tracker;
+    const RoutePlanner &routes;
+    const TargetChoices &choices;
 };
 
-struct DBSearching : DroneBehavior {
-    DBSearching(DroneState &drone, Quadrant quadrant);
-    virtual unique_ptr<DroneBehavior> getCopy(DroneState &drone) const override;
-    virtual void TryChange() override;
-    virtual void Process() override;
+// Behaviors are plain values stored inline in their drone: switching allocates nothing and copying a drone copies its
+// behavior. TryChange returns the behavior to switch to, if any.
+using DroneBehavior = variant<DBSurfacing, DBSearching>;
 
-    Quadrant currentTarget;
+struct DBSurfacing {
+    optional<DroneBehavior> TryChange(const DroneState &drone, const GameState &game, const TurnContext &context) const;
+    void Process(DroneState &drone, const GameState &game, const TurnContext &context) const;
 };
 
-optional<Quadrant> findNextTargetForDrone(const DroneState &drone, PlayerState &state,
-                                          CreatureStateSet &visibleEnemies);
-optional<Quadrant> findNewTargetsByRadar(const DroneState &drone, PlayerState &state, CreatureStateSet &visibleEnemies);
-Coord cleanupDirection(Coord position, Coord target, CreatureStateSet creatures);
+struct DBSearching {
+    optional<DroneBehavior> TryChange(const DroneState &drone, const GameState &game, const TurnContext &context);
+    void Process(DroneState &drone, const GameState &game, const TurnContext &context) const;
+
+    Quadrant currentTarget;
+};
 
+optional<Quadrant> findNextTargetForDrone(const DroneState &drone, const PlayerState &state,
+                                          const CreatureStateSet &visibleEnemies, const RoutePlanner &routes);
+optional<Quadrant> findNewTargetsByRadar(const DroneState &drone, const PlayerState &state,
+                                         const CreatureStateSet &visibleEnemies);
+optional<Quadrant> chooseTargetForDrone(const DroneState &drone, const GameState &game, const TurnContext &context);
+double scoreTargetChoice(const DroneState &drone, Quadrant quadrant, const PlayerState &state,
+                         const CreatureStateSet &visibleEnemies);
+Coord getLikelyTarget(const DroneState &drone, Quadrant quadrant, const PlayerState &state,
+                      const TurnContext &context);
+Coord cleanupDirection(Coord position, Coord target, const CreatureStateSet &creatures);
+Coord findSafeTarget(const SimState &sim, int droneIndex, Coord target, bool useLight);
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+
+using namespace std;
+
+// Vector with its storage inline, so a struct holding one stays trivially copyable when T is.
+template <typename T, int CAPACITY>
+struct FixedVector {
+    using iterator = T *;
+    using const_iterator = const T *;
+
+    iterator begin() { return items.data(); }
+    iterator end() { return items.data() + count; }
+    const_iterator begin() const { return items.data(); }
+    const_iterator end() const { return items.data() + count; }
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+    T &operator[](int index) { return items[index]; }
+    const T &operator[](int index) const { return items[index]; }
+    void push_back(const T &item) {
+        assert(count < CAPACITY);
+        items[count++] = item;
+    }
+    void clear() { count = 0; }
+
+    array<T, CAPACITY> items;
+    int count = 0;
+};
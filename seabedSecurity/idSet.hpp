@@ -0,0 +1,115 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+
+using namespace std;
+
+// Entity ids (creatures, monsters, drones) are small, so sets of them fit in one machine word.
+const int MAX_ENTITY_ID = 64;
+
+// Set of ids as a bitset. Iterates in increasing id order, like the set<int> it replaces.
+struct IntSet {
+    struct iterator {
+        int operator*() const { return __builtin_ctzll(bits); }
+        iterator &operator++() {
+            bits &= bits - 1;
+            return *this;
+        }
+        bool operator!=(const iterator &other) const { return bits != other.bits; }
+
+        uint64_t bits;
+    };
+
+    static uint64_t bit(int id) {
+        assert(id >= 0 && id < MAX_ENTITY_ID);
+        return uint64_t(1) << id;
+    }
+
+    void insert(int id) { bits |= bit(id); }
+    void erase(int id) { bits &= ~bit(id); }
+    int count(int id) const { return (bits & bit(id)) != 0; }
+    int size() const { return __builtin_popcountll(bits); }
+    bool empty() const { return bits == 0; }
+    void clear() { bits = 0; }
+    iterator begin() const { return iterator{bits}; }
+    iterator end() const { return iterator{0}; }
+
+    IntSet operator|(IntSet other) const { return IntSet{bits | other.bits}; }
+    IntSet operator&(IntSet other) const { return IntSet{bits & other.bits}; }
+    IntSet operator-(IntSet other) const { return IntSet{bits & ~other.bits}; }
+    IntSet &operator|=(IntSet other) {
+        bits |= other.bits;
+        return *this;
+    }
+    IntSet &operator-=(IntSet other) {
+        bits &= ~other.bits;
+        return *this;
+    }
+    template <typename Predicate> IntSet filter(Predicate predicate) const {
+        IntSet result{0};
+        for (int id : *this)
+            if (predicate(id))
+                result.insert(id);
+        return result;
+    }
+
+    uint64_t bits = 0;
+};
+
+// Entities with an int id member stored in a flat array slot per id. Iterates present entities in id order.
+template <typename T> struct IdMap {
+    struct iterator {
+        T &operator*() const { return map->slots[*ids]; }
+        T *operator->() const { return &map->slots[*ids]; }
+        iterator &operator++() {
+            ++ids;
+            return *this;
+        }
+        bool operator!=(const iterator &other) const { return ids != other.ids; }
+
+        IdMap *map;
+        IntSet::iterator ids;
+    };
+    struct const_iterator {
+        const T &operator*() const { return map->slots[*ids]; }
+        const T *operator->() const { return &map->slots[*ids]; }
+        const_iterator &operator++() {
+            ++ids;
+            return *this;
+        }
+        bool operator!=(const const_iterator &other) const { return ids != other.ids; }
+
+        const IdMap *map;
+        IntSet::iterator ids;
+    };
+
+    void insert(const T &value) {
+        ids.insert(value.id);
+        slots[value.id] = value;
+    }
+    void erase(int id) { ids.erase(id); }
+    int count(int id) const { return ids.count(id); }
+    const T &at(int id) const {
+        assert(ids.count(id));
+        return slots[id];
+    }
+    int size() const { return ids.size(); }
+    bool empty() const { return ids.empty(); }
+    void clear() { ids.clear(); }
+    iterator begin() { return iterator{this, ids.begin()}; }
+    iterator end() { return iterator{this, ids.end()}; }
+    const_iterator begin() const { return const_iterator{this, ids.begin()}; }
+    const_iterator end() const { return const_iterator{this, ids.end()}; }
+    template <typename Predicate> IdMap filter(Predicate predicate) const {
+        IdMap result;
+        for (const T &value : *this)
+            if (predicate(value))
+                result.insert(value);
+        return result;
+    }
+
+    IntSet ids;
+    array<T, MAX_ENTITY_ID> slots;
+};
@@ -1,15 +1,48 @@
 #include <iostream>
 
+#include "../common/replay.hpp"
+#include "../common/turnBudget.hpp"
 #include "states.hpp"
 #include "drone.hpp"
 
-int main() {
-    GameConfig& config = GameConfig::get();
-    GameState& state = GameState::get();
+void playTurn(GameState &state, InputReader &in) {
+    PROFILE_ZONE("turn");
+    state.parseInput(in);
+    state.own.calculateRemainingCreatures();
+    DroneState::runAllOwnDrones(state);
+}
+
+#if !defined(BENCH) && !defined(REFEREE)
+int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv) {
+    GameState state;
+    TurnBudget::get().configure();
+
+#ifdef REPLAY
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <replay log>\n", argv[0]);
+        return 1;
+    }
+    return runReplay(argv[1], [](InputReader &in) { GameConfig::get().parseInput(in); },
+                     [&state](InputReader &in) { playTurn(state, in); });
+#else
+#ifdef TUNABLE
+    if (argc > 1)
+        loadParameters(argv[1]);
+#endif
+#ifdef RECORD_REPLAY
+    ReplayRecorder::get().start(cerr);
+#endif
+    InputReader &in = InputReader::get();
+    GameConfig::get().parseInput(in);
 
-    while (true) {
-        state.parseInput(cin);
-        state.own.calculateRemainingCreatures();
-        DroneState::runAllOwnDrones();
+    while (in.peek() != EOF) {
+        TurnBudget::get().startTurn();
+        ReplayRecorder::get().beginTurn();
+        playTurn(state, in);
+        ReplayRecorder::get().endTurn();
+        PROFILE_TURN();
     }
+    PROFILE_DUMP();
+#endif
 }
+#endif
@@ -0,0 +1,287 @@
+#include <cmath>
+#include <random>
+#include <sstream>
+
+#include "../../common/tournament.hpp"
+#include "../../common/tuner.hpp"
+#include "../config.hpp"
+#include "../simulator.hpp"
+
+// Local referee for Seabed Security on top of the bot's own simulateTick(). Seat 0 flies drones 0 and 2, seat 1
+// drones 1 and 3. The referee adds what the bots never simulate: map generation, radar, visibility and scoring.
+namespace {
+    const int MAX_TURNS = 200;
+    const int COLOR_COUNT = 4;
+    const int TYPE_COUNT = 3;
+    const int FIRST_FISH_ID = 4;
+    const int FISH_COUNT = COLOR_COUNT * TYPE_COUNT;
+    const int DRONES_PER_PLAYER = 2;
+    const int MAX_MONSTER_PAIRS = 3;
+    const int COLOR_BONUS = 3;
+    const int TYPE_BONUS = 4;
+
+    struct Game {
+        SimState sim;
+        int monsterCount;
+        array<int, 2> scores;
+        // Bits are color and type indices.
+        array<IntSet, 2> completedColors;
+        array<IntSet, 2> completedTypes;
+    };
+
+    int getFishId(int type, int color) {
+        return FIRST_FISH_ID + type * COLOR_COUNT + color;
+    }
+
+    int getFishType(int fishId) {
+        return (fishId - FIRST_FISH_ID) / COLOR_COUNT;
+    }
+
+    Coord mirror(Coord position) {
+        return Coord{MAP_SIZE - 1 - position.x, position.y};
+    }
+
+    Coord randomVelocity(mt19937_64 &random, int speed) {
+        double angle = uniform_real_distribution<double>(0, 2 * M_PI)(random);
+        return Coord{static_cast<int>(cos(angle) * speed), static_cast<int>(sin(angle) * speed)};
+    }
+
+    // Everything comes in pairs mirrored left to right, so neither seat starts with the better half of the ocean.
+    Game generateGame(uint64_t seed) {
+        mt19937_64 random(seed);
+        auto uniform = [&](int low, int high) { return uniform_int_distribution<int>(low, high)(random); };
+        Game game{};
+        SimState &sim = game.sim;
+
+        sim.droneCount = 2 * DRONES_PER_PLAYER;
+        FORN(pair, DRONES_PER_PLAYER) {
+            Coord position{uniform(pair * MAP_SIZE / 4, (pair + 1) * MAP_SIZE / 4), SURFACE_DEPTH};
+            sim.drones[2 * pair] = SimDrone{2 * pair, 0, position, MAX_BATTERY, false, false, IntSet{}};
+            sim.drones[2 * pair + 1] = SimDrone{2 * pair + 1, 1, mirror(position), MAX_BATTERY, false, false, IntSet{}};
+        }
+
+        FORN(type, TYPE_COUNT) {
+            for (int color = 0; color < COLOR_COUNT; color += 2) {
+                Type fishType = static_cast<Type>(type);
+                Coord position{uniform(0, MAP_SIZE - 1), uniform(getHabitatTop(fishType), getHabitatBottom(fishType))};
+                Coord velocity = randomVelocity(random, FISH_SWIM_SPEED);
+                sim.fish[sim.fishCount++] = SimCreature{getFishId(type, color), fishType, position, velocity};
+                sim.fish[sim.fishCount++] = SimCreature{getFishId(type, color + 1), fishType, mirror(position),
+                                                        Coord{-velocity.x, velocity.y}};
+            }
+        }
+
+        int monsterPairs = uniform(1, MAX_MONSTER_PAIRS);
+        FORN(pair, monsterPairs) {
+            Coord position{uniform(0, MAP_SIZE - 1), uniform(MONSTER_MIN_DEPTH, MAP_SIZE - 1)};
+            Coord velocity = randomVelocity(random, MONSTER_SPEED);
+            int id = FIRST_FISH_ID + FISH_COUNT + 2 * pair;
+            sim.monsters[sim.monsterCount++] = SimCreature{id, Type::ENEMY, position, velocity};
+            sim.monsters[sim.monsterCount++] =
+                SimCreature{id + 1, Type::ENEMY, mirror(position), Coord{-velocity.x, velocity.y}};
+        }
+        game.monsterCount = sim.monsterCount;
+        return game;
+    }
+
+    string formatConfig(const Game &game) {
+        ostringstream out;
+        out << FISH_COUNT + game.monsterCount << "\n";
+        FORN(type, TYPE_COUNT) {
+            FORN(color, COLOR_COUNT)
+                out << getFishId(type, color) << " " << color << " " << type << "\n";
+        }
+        FORN(monster, game.monsterCount)
+            out << FIRST_FISH_ID + FISH_COUNT + monster << " -1 -1\n";
+        return out.str();
+    }
+
+    const char *getRadar(Coord drone, Coord creature) {
+        if (creature.y < drone.y)
+            return creature.x < drone.x ? "TL" : "TR";
+        return creature.x < drone.x ? "BL" : "BR";
+    }
+
+    string formatTurn(const Game &game, int seat) {
+        const SimState &sim = game.sim;
+        ostringstream out;
+        out << game.scores[seat] << "\n" << game.scores[1 - seat] << "\n";
+        for (int player : {seat, 1 - seat}) {
+            out << sim.savedScans[player].size() << "\n";
+            for (int id : sim.savedScans[player])
+                out << id << "\n";
+        }
+        for (int player : {seat, 1 - seat}) {
+            out << DRONES_PER_PLAYER << "\n";
+            FORN(d, sim.droneCount) {
+                const SimDrone &drone = sim.drones[d];
+                if (drone.player == player)
+                    out << drone.id << " " << drone.position.x << " " << drone.position.y << " " << drone.emergency
+                        << " " << drone.battery << "\n";
+            }
+        }
+
+        ostringstream scans;
+        int scanCount = 0;
+        FORN(d, sim.droneCount) {
+            for (int id : sim.drones[d].scans) {
+                scans << sim.drones[d].id << " " << id << "\n";
+                scanCount++;
+            }
+        }
+        out << scanCount << "\n" << scans.str();
+
+        // Fish that swam off the map are gone for good, so everything left is in one of these two arrays.
+        vector<const SimCreature *> creatures;
+        FORN(f, sim.fishCount)
+            creatures.push_back(&sim.fish[f]);
+        FORN(m, sim.monsterCount)
+            creatures.push_back(&sim.monsters[m]);
+
+        ostringstream visible;
+        int visibleCount = 0;
+        for (const SimCreature *creature : creatures) {
+            bool lit = false;
+            FORN(d, sim.droneCount) {
+                const SimDrone &drone = sim.drones[d];
+                int radius = drone.light ? LIGHT_SCAN_RADIUS : SCAN_RADIUS;
+                lit |= drone.player == seat && getSqDistance(drone.position, creature->position) <= radius * radius;
+            }
+            if (!lit)
+                continue;
+            visible << creature->id << " " << creature->position.x << " " << creature->position.y << " "
+                    << creature->velocity.x << " " << creature->velocity.y << "\n";
+            visibleCount++;
+        }
+        out << visibleCount << "\n" << visible.str();
+
+        out << DRONES_PER_PLAYER * creatures.size() << "\n";
+        FORN(d, sim.droneCount) {
+            const SimDrone &drone = sim.drones[d];
+            if (drone.player != seat)
+                continue;
+            for (const SimCreature *creature : creatures)
+                out << drone.id << " " << creature->id << " " << getRadar(drone.position, creature->position) << "\n";
+        }
+        return out.str();
+    }
+
+    // Anything unreadable makes the drone wait in the dark, the way the referee ignores it.
+    DroneCommand parseCommand(const string &line) {
+        istringstream words(line);
+        string kind;
+        int x, y, light;
+        words >> kind;
+        if (kind == "MOVE" && words >> x >> y >> light)
+            return DroneCommand::move(Coord{x, y}, light != 0);
+        if (kind == "WAIT" && words >> light)
+            return DroneCommand::wait(light != 0);
+        return DroneCommand::wait(false);
+    }
+
+    // Points for what was saved since savedBefore. Saving a creature first, or on the same turn as the foe, doubles
+    // its points, and so does completing a color or a type first.
+    void scoreSaves(Game &game, const array<IntSet, 2> &savedBefore) {
+        array<IntSet, 2> colorsBefore = game.completedColors;
+        array<IntSet, 2> typesBefore = game.completedTypes;
+        FORN(player, 2) {
+            int foe = 1 - player;
+            const IntSet &saved = game.sim.savedScans[player];
+            for (int id : saved - savedBefore[player]) {
+                int points = getFishType(id) + 1;
+                game.scores[player] += savedBefore[foe].count(id) ? points : 2 * points;
+            }
+
+            FORN(color, COLOR_COUNT) {
+                bool complete = true;
+                FORN(type, TYPE_COUNT)
+                    complete &= saved.count(getFishId(type, color)) != 0;
+                if (!complete || colorsBefore[player].count(color))
+                    continue;
+                game.completedColors[player].insert(color);
+                game.scores[player] += colorsBefore[foe].count(color) ? COLOR_BONUS : 2 * COLOR_BONUS;
+            }
+            FORN(type, TYPE_COUNT) {
+                bool complete = true;
+                FORN(color, COLOR_COUNT)
+                    complete &= saved.count(getFishId(type, color)) != 0;
+                if (!complete || typesBefore[player].count(type))
+                    continue;
+                game.completedTypes[player].insert(type);
+                game.scores[player] += typesBefore[foe].count(type) ? TYPE_BONUS : 2 * TYPE_BONUS;
+            }
+        }
+    }
+
+    bool canStillScore(const Game &game, int player) {
+        const SimState &sim = game.sim;
+        FORN(f, sim.fishCount) {
+            if (!sim.savedScans[player].count(sim.fish[f].id))
+                return true;
+        }
+        FORN(d, sim.droneCount) {
+            if (sim.drones[d].player == player && !sim.drones[d].scans.empty())
+                return true;
+        }
+        return false;
+    }
+
+    MatchResult playMatch(uint64_t seed, Match &match) {
+        Game game = generateGame(seed);
+        SimState &sim = game.sim;
+        MatchResult result;
+        string config = formatConfig(game);
+        array<string, 2> inputs;
+        array<vector<string>, 2> outputs;
+
+        while (result.turns < MAX_TURNS && (canStillScore(game, 0) || canStillScore(game, 1))) {
+            FORN(seat, 2)
+                inputs[seat] = (result.turns == 0 ? config : "") + formatTurn(game, seat);
+            if (!match.playTurn(inputs, DRONES_PER_PLAYER, outputs))
+                break;
+            result.turns++;
+
+            // Drone d belongs to player d % 2 and is its (d / 2)th drone, the order the bot answers in.
+            DroneCommands commands;
+            FORN(d, sim.droneCount)
+                commands[d] = parseCommand(outputs[sim.drones[d].player][d / 2]);
+            array<IntSet, 2> savedBefore = sim.savedScans;
+            simulateTick(sim, commands);
+            scoreSaves(game, savedBefore);
+        }
+
+        // Scans still on board count at the end of the match.
+        array<IntSet, 2> savedBefore = sim.savedScans;
+        FORN(d, sim.droneCount)
+            sim.savedScans[sim.drones[d].player] |= sim.drones[d].scans;
+        scoreSaves(game, savedBefore);
+
+        FORN(seat, 2)
+            result.scores[seat] = game.scores[seat];
+        if (game.scores[0] != game.scores[1])
+            result.winner = game.scores[0] > game.scores[1] ? 0 : 1;
+        return result;
+    }
+}
+
+// "referee <bot A> <bot B> [flags]" plays a tournament, "referee tune <tunable bot> [flags]" tunes the constants
+// listed in TUNED_PARAMETERS.
+int main(int argc, char **argv) {
+    bool tune = argc > 1 && string(argv[1]) == "tune";
+    TournamentOptions options;
+    TunerOptions tuner;
+    auto noGameFlags = [](const string &, const char *) { return false; };
+    bool parsed = tune ? parseTunerOptions(argc - 1, argv + 1, options, tuner, noGameFlags)
+                       : parseTournamentOptions(argc, argv, 2, options, noGameFlags);
+    if (!parsed) {
+        fprintf(stderr,
+                "Usage: %s <bot A> <bot B> [--games N] [--seed S] [--threads T] [--first-timeout MS] [--timeout MS]\n"
+                "       %s tune <tunable bot> [--iterations N] [--games N] [--verify-games N] [--output PATH] ...\n",
+                argv[0], argv[0]);
+        return 1;
+    }
+
+    if (tune)
+        return runTuner(options, tuner, {TUNED_PARAMETERS(PARAMETER_INFO)}, playMatch);
+    return runTournament(options, playMatch);
+}
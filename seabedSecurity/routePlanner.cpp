@@ -0,0 +1,211 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "../common/turnBudget.hpp"
+#include "routePlanner.hpp"
+#include "creatureTracker.hpp"
+#include "drone.hpp"
+#include "simulator.hpp"
+
+namespace {
+    int getTravelTurns(Coord from, Coord to, int reach) {
+        double distance = sqrt(getSqDistance(from, to)) - reach;
+        return distance > 0 ? static_cast<int>(ceil(distance / DRONE_MOVE_SPEED)) : 0;
+    }
+
+    void removeAt(Route &route, int index) {
+        copy(route.creatures.begin() + index + 1, route.creatures.begin() + route.length,
+             route.creatures.begin() + index);
+        route.length--;
+    }
+
+    void insertAt(Route &route, int index, int creatureId) {
+        copy_backward(route.creatures.begin() + index, route.creatures.begin() + route.length,
+                      route.creatures.begin() + route.length + 1);
+        route.creatures[index] = creatureId;
+        route.length++;
+    }
+}
+
+RoutePlanner& RoutePlanner::get() {
+    static RoutePlanner routePlanner;
+    return routePlanner;
+}
+
+RoutePlanner::RoutePlanner() : rng(0) {
+    best.routeCount = 0;
+    FORI(MAX_ROUTE_TURNS + 1)
+        discounts[i] = pow(ROUTE_TURN_DISCOUNT, i);
+}
+
+void RoutePlanner::plan(const GameState &game, const CreatureTracker &tracker) {
+    PROFILE_ZONE("routes");
+    using Clock = chrono::steady_clock;
+    long budget = min<long>(ROUTE_BUDGET_MICROSECONDS, TurnBudget::get().timeLeft() - LOOKAHEAD_RESERVE_MICROSECONDS);
+    Clock::time_point deadline = Clock::now() + chrono::microseconds(budget);
+
+    candidates.clear();
+    for (int creatureId : game.own.remainingCreatures) {
+        if (tracker.isTracked(creatureId)) {
+            candidates.insert(creatureId);
+            estimates[creatureId] = tracker.getEstimate(creatureId);
+            points[creatureId] = getScanPoints(creatureId, game.foe);
+        }
+    }
+
+    // Keep last turn's routes for the drones still around, minus what is no longer worth visiting.
+    Plan seed;
+    seed.routeCount = 0;
+    for (const DroneState &drone : game.own.drones) {
+        if (seed.routeCount == MAX_PLANNED_DRONES)
+            break;
+        int index = seed.routeCount++;
+        dronePositions[index] = drone.position;
+        heldPoints[index] = 0;
+        for (int creatureId : drone.currentScans)
+            heldPoints[index] += getScanPoints(creatureId, game.foe);
+
+        Route &route = seed.routes[index];
+        route = Route{drone.id, {}, 0};
+        FORN(r, best.routeCount) {
+            if (best.routes[r].droneId != drone.id)
+                continue;
+            FORN(c, best.routes[r].length) {
+                int creatureId = best.routes[r].creatures[c];
+                if (candidates.count(creatureId))
+                    route.creatures[route.length++] = creatureId;
+            }
+        }
+    }
+    best = seed;
+    // Short on time, last turn's routes are still a sound plan.
+    if (best.routeCount == 0 || budget <= 0)
+        return;
+
+    Plan current = best;
+    double currentScore = evaluate(current);
+    double bestScore = currentScore;
+    const double startTemperature = 2.0;
+    const double endTemperature = 0.01;
+    Clock::time_point start = Clock::now();
+    double duration = chrono::duration<double>(deadline - start).count();
+    double temperature = startTemperature;
+    for (int iteration = 0;; iteration++) {
+        if ((iteration & 63) == 0) {
+            double elapsed = chrono::duration<double>(Clock::now() - start).count();
+            if (elapsed >= duration)
+                break;
+            temperature = startTemperature * pow(endTemperature / startTemperature, elapsed / duration);
+        }
+
+        Plan next = current;
+        if (!mutate(next))
+            continue;
+        double score = evaluate(next);
+        if (score >= currentScore ||
+            uniform_real_distribution<double>(0, 1)(rng) < exp((score - currentScore) / temperature)) {
+            current = next;
+            currentScore = score;
+            if (score > bestScore) {
+                best = next;
+                bestScore = score;
+            }
+        }
+    }
+}
+
+optional<int> RoutePlanner::getNextCreature(int droneId) const {
+    FORI(best.routeCount) {
+        if (best.routes[i].droneId == droneId && best.routes[i].length > 0)
+            return best.routes[i].creatures[0];
+    }
+    return {};
+}
+
+bool RoutePlanner::isSurfacing(int droneId) const {
+    FORI(best.routeCount) {
+        if (best.routes[i].droneId == droneId)
+            return best.routes[i].length == 0 && !candidates.empty();
+    }
+    return false;
+}
+
+double RoutePlanner::evaluate(const Plan &plan) const {
+    double score = 0;
+    FORN(r, plan.routeCount) {
+        const Route &route = plan.routes[r];
+        Coord position = dronePositions[r];
+        int turns = 0;
+        double saved = heldPoints[r];
+        FORI(route.length) {
+            int creatureId = route.creatures[i];
+            turns += getTravelTurns(position, estimates[creatureId], SCAN_RADIUS);
+            position = estimates[creatureId];
+            saved += points[creatureId];
+        }
+        turns += getTravelTurns(position, Coord{position.x, 0}, SURFACE_DEPTH);
+        score += saved * discounts[min(turns, MAX_ROUTE_TURNS)];
+    }
+    return score;
+}
+
+bool RoutePlanner::mutate(Plan &plan) {
+    uniform_int_distribution<int> routeDistribution(0, plan.routeCount - 1);
+    switch (uniform_int_distribution<int>(0, 2)(rng)) {
+    case 0: {
+        // Relocate a creature, taking it from the unplanned ones or from a route, into a route or out of the plan.
+        int creatureCount = candidates.size();
+        if (creatureCount == 0)
+            return false;
+        int skip = uniform_int_distribution<int>(0, creatureCount - 1)(rng);
+        int creatureId = 0;
+        for (int candidate : candidates) {
+            creatureId = candidate;
+            if (skip-- == 0)
+                break;
+        }
+        FORN(r, plan.routeCount) {
+            Route &route = plan.routes[r];
+            int *found = find(route.creatures.begin(), route.creatures.begin() + route.length, creatureId);
+            if (found != route.creatures.begin() + route.length)
+                removeAt(route, found - route.creatures.begin());
+        }
+        if (uniform_int_distribution<int>(0, 4)(rng) == 0)
+            return true;
+        Route &route = plan.routes[routeDistribution(rng)];
+        if (route.length == MAX_ROUTE_LENGTH)
+            return false;
+        insertAt(route, uniform_int_distribution<int>(0, route.length)(rng), creatureId);
+        return true;
+    }
+    case 1: {
+        // Swap two visits, possibly between drones.
+        Route &first = plan.routes[routeDistribution(rng)];
+        Route &second = plan.routes[routeDistribution(rng)];
+        if (first.length == 0 || second.length == 0)
+            return false;
+        swap(first.creatures[uniform_int_distribution<int>(0, first.length - 1)(rng)],
+             second.creatures[uniform_int_distribution<int>(0, second.length - 1)(rng)]);
+        return true;
+    }
+    default: {
+        // Reverse a stretch of one route.
+        Route &route = plan.routes[routeDistribution(rng)];
+        if (route.length < 2)
+            return false;
+        int from = uniform_int_distribution<int>(0, route.length - 2)(rng);
+        int to = uniform_int_distribution<int>(from + 1, route.length - 1)(rng);
+        reverse(route.creatures.begin() + from, route.creatures.begin() + to + 1);
+        return true;
+    }
+    }
+}
+
+double getScanPoints(int creatureId, const PlayerState &foe) {
+    const GameConfig &config = GameConfig::get();
+    if (!config.creatures.count(creatureId))
+        return 0;
+    double points = static_cast<int>(config.creatures.at(creatureId).type) + 1;
+    return foe.totalScans.count(creatureId) ? points : 2 * points;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+#include <optional>
+#include <random>
+
+#include "config.hpp"
+#include "coord.hpp"
+#include "states.hpp"
+
+struct CreatureTracker;
+
+const int MAX_PLANNED_DRONES = 2;
+const int MAX_ROUTE_LENGTH = 12;
+const int MAX_ROUTE_TURNS = 200;
+
+// Creatures one drone visits in order before surfacing.
+struct Route {
+    int droneId;
+    array<int, MAX_ROUTE_LENGTH> creatures;
+    int length;
+};
+
+// Splits the remaining creatures between the own drones and orders each drone's visits, by simulated annealing over
+// relocate, swap and reverse moves. A plan is worth the points of every scan it saves, discounted by the turns until
+// its drone surfaces. The previous turn's plan, minus the creatures already scanned or gone, seeds the next search.
+struct RoutePlanner {
+    static RoutePlanner& get();
+    RoutePlanner();
+    void plan(const GameState &game, const CreatureTracker &tracker);
+    // Next creature for the drone to scan, nothing when it should surface.
+    optional<int> getNextCreature(int droneId) const;
+    // True when there is something left to scan but the plan rather has the drone save what it holds.
+    bool isSurfacing(int droneId) const;
+
+    struct Plan {
+        array<Route, MAX_PLANNED_DRONES> routes;
+        int routeCount;
+    };
+
+    double evaluate(const Plan &plan) const;
+    bool mutate(Plan &plan);
+
+    Plan best;
+    mt19937 rng;
+
+    // Per turn inputs of evaluate.
+    array<Coord, MAX_PLANNED_DRONES> dronePositions;
+    array<double, MAX_PLANNED_DRONES> heldPoints;
+    array<Coord, MAX_ENTITY_ID> estimates;
+    array<double, MAX_ENTITY_ID> points;
+    IntSet candidates;
+    array<double, MAX_ROUTE_TURNS + 1> discounts;
+};
+
+// Points a scan of creature saves, doubled when the foe has not saved it yet.
+double getScanPoints(int creatureId, const PlayerState &foe);
@@ -0,0 +1,253 @@
+#include <algorithm>
+#include <cmath>
+
+#include "simulator.hpp"
+#include "drone.hpp"
+#include "states.hpp"
+#include "sweep.hpp"
+
+namespace {
+    // Moves from towards to by at most speed units, rounding the result like the referee.
+    Coord stepTowards(Coord from, Coord to, int speed) {
+        double dx = to.x - from.x;
+        double dy = to.y - from.y;
+        double length = sqrt(dx * dx + dy * dy);
+        if (length <= speed)
+            return to;
+        return Coord{static_cast<int>(round(from.x + dx * speed / length)),
+                     static_cast<int>(round(from.y + dy * speed / length))};
+    }
+
+    Coord scaleTo(double dx, double dy, int speed) {
+        double length = sqrt(dx * dx + dy * dy);
+        if (length == 0)
+            return Coord{0, 0};
+        return Coord{static_cast<int>(dx * speed / length), static_cast<int>(dy * speed / length)};
+    }
+
+    Coord clampToMap(Coord position) {
+        return Coord{clamp(position.x, 0, MAP_SIZE - 1), clamp(position.y, 0, MAP_SIZE - 1)};
+    }
+
+    int lightRadius(const SimDrone &drone) {
+        return drone.light ? LIGHT_SCAN_RADIUS : SCAN_RADIUS;
+    }
+
+    void moveFish(SimState &state) {
+        int kept = 0;
+        FORN(f, state.fishCount) {
+            SimCreature &fish = state.fish[f];
+            const SimDrone *closest = nullptr;
+            int closestDistance = FISH_FLEE_RADIUS * FISH_FLEE_RADIUS;
+            FORN(d, state.droneCount) {
+                int distance = getSqDistance(state.drones[d].position, fish.position);
+                if (distance < closestDistance) {
+                    closestDistance = distance;
+                    closest = &state.drones[d];
+                }
+            }
+
+            bool fleeing = closest != nullptr;
+            if (fleeing)
+                fish.velocity = scaleTo(fish.position.x - closest->position.x, fish.position.y - closest->position.y,
+                                        FISH_FLEE_SPEED);
+            else
+                fish.velocity = scaleTo(fish.velocity.x, fish.velocity.y, FISH_SWIM_SPEED);
+
+            Coord next = fish.position + fish.velocity;
+            int top = getHabitatTop(fish.type);
+            int bottom = getHabitatBottom(fish.type);
+            if (next.y < top || next.y > bottom) {
+                fish.velocity.y = -fish.velocity.y;
+                next.y = clamp(next.y, top, bottom);
+            }
+            // Scared fish swim off the map for good, calm ones turn around at the edge.
+            if (next.x < 0 || next.x >= MAP_SIZE) {
+                if (fleeing)
+                    continue;
+                fish.velocity.x = -fish.velocity.x;
+                next.x = clamp(next.x, 0, MAP_SIZE - 1);
+            }
+            fish.position = next;
+            state.fish[kept++] = fish;
+        }
+        state.fishCount = kept;
+    }
+
+    // Monsters chase the closest drone they can see in its light, otherwise they keep drifting slowly.
+    void steerMonsters(SimState &state) {
+        FORN(m, state.monsterCount) {
+            SimCreature &monster = state.monsters[m];
+            const SimDrone *target = nullptr;
+            int targetDistance = 0;
+            FORN(d, state.droneCount) {
+                const SimDrone &drone = state.drones[d];
+                int distance = getSqDistance(drone.position, monster.position);
+                if (!drone.emergency && distance <= lightRadius(drone) * lightRadius(drone) &&
+                    (!target || distance < targetDistance)) {
+                    target = &drone;
+                    targetDistance = distance;
+                }
+            }
+
+            if (target)
+                monster.velocity = scaleTo(target->position.x - monster.position.x,
+                                           target->position.y - monster.position.y, MONSTER_CHASE_SPEED);
+            else
+                monster.velocity = scaleTo(monster.velocity.x, monster.velocity.y, MONSTER_SPEED);
+        }
+    }
+
+    void moveMonsters(SimState &state) {
+        FORN(m, state.monsterCount) {
+            SimCreature &monster = state.monsters[m];
+            Coord next = monster.position + monster.velocity;
+            if (next.y < MONSTER_MIN_DEPTH || next.y >= MAP_SIZE)
+                monster.velocity.y = -monster.velocity.y;
+            if (next.x < 0 || next.x >= MAP_SIZE)
+                monster.velocity.x = -monster.velocity.x;
+            next.y = clamp(next.y, MONSTER_MIN_DEPTH, MAP_SIZE - 1);
+            monster.position = clampToMap(next);
+        }
+    }
+}
+
+int getHabitatTop(Type type) {
+    switch (type) {
+    case Type::OCTUPUS:
+        return 2500;
+    case Type::FISH:
+        return 5000;
+    case Type::CRAB:
+        return 7500;
+    default:
+        return MONSTER_MIN_DEPTH;
+    }
+}
+
+int getHabitatBottom(Type type) {
+    switch (type) {
+    case Type::OCTUPUS:
+        return 5000;
+    case Type::FISH:
+        return 7500;
+    default:
+        return MAP_SIZE - 1;
+    }
+}
+
+SimState SimState::fromGame(const GameState &game) {
+    SimState state;
+    state.droneCount = 0;
+    auto addDrones = [&](const PlayerState &player, int playerIndex) {
+        for (const DroneState &drone : player.drones) {
+            if (state.droneCount == MAX_SIM_DRONES)
+                return;
+            state.drones[state.droneCount++] = SimDrone{drone.id,        playerIndex, drone.position, drone.battery,
+                                                        drone.emergency != 0, false, drone.currentScans};
+        }
+    };
+    addDrones(game.own, 0);
+    addDrones(game.foe, 1);
+
+    const GameConfig &config = GameConfig::get();
+    state.fishCount = 0;
+    for (const CreatureState &creature : game.visibleCreatures) {
+        if (state.fishCount < MAX_SIM_FISH && config.creatures.count(creature.id))
+            state.fish[state.fishCount++] =
+                SimCreature{creature.id, config.creatures.at(creature.id).type, creature.position, creature.velocity};
+    }
+    state.monsterCount = 0;
+    for (const CreatureState &monster : game.visibleEnemies) {
+        if (state.monsterCount < MAX_SIM_MONSTERS)
+            state.monsters[state.monsterCount++] = SimCreature{monster.id, Type::ENEMY, monster.position, monster.velocity};
+    }
+
+    state.savedScans[0] = game.own.totalScans;
+    state.savedScans[1] = game.foe.totalScans;
+    state.turn = 0;
+    return state;
+}
+
+int SimState::findDrone(int droneId) const {
+    FORI(droneCount) {
+        if (drones[i].id == droneId)
+            return i;
+    }
+    return -1;
+}
+
+void simulateTick(SimState &state, const DroneCommands &commands) {
+    array<Coord, MAX_SIM_DRONES> startPositions;
+    FORN(d, state.droneCount) {
+        SimDrone &drone = state.drones[d];
+        const DroneCommand &command = commands[d];
+        startPositions[d] = drone.position;
+
+        if (drone.emergency) {
+            drone.light = false;
+            drone.position.y = max(0, drone.position.y - DRONE_EMERGENCY_SPEED);
+        } else {
+            drone.light = command.light && drone.battery >= LIGHT_BATTERY_COST;
+            if (command.idle)
+                drone.position.y = min(MAP_SIZE - 1, drone.position.y + DRONE_SINK_SPEED);
+            else
+                drone.position = clampToMap(stepTowards(drone.position, command.target, DRONE_MOVE_SPEED));
+        }
+        drone.battery = drone.light ? drone.battery - LIGHT_BATTERY_COST : min(MAX_BATTERY, drone.battery + 1);
+    }
+
+    FORN(d, state.droneCount) {
+        SimDrone &drone = state.drones[d];
+        if (drone.emergency)
+            continue;
+        FORN(m, state.monsterCount) {
+            const SimCreature &monster = state.monsters[m];
+            if (segmentsCollide(startPositions[d], drone.position, monster.position, monster.velocity,
+                                 MONSTER_KILL_RADIUS)) {
+                drone.emergency = true;
+                drone.scans.clear();
+                break;
+            }
+        }
+    }
+
+    moveMonsters(state);
+    moveFish(state);
+
+    FORN(d, state.droneCount) {
+        SimDrone &drone = state.drones[d];
+        if (drone.emergency) {
+            if (drone.position.y == 0)
+                drone.emergency = false;
+            continue;
+        }
+        int radius = lightRadius(drone);
+        FORN(f, state.fishCount) {
+            const SimCreature &fish = state.fish[f];
+            if (getSqDistance(drone.position, fish.position) <= radius * radius &&
+                !state.savedScans[drone.player].count(fish.id))
+                drone.scans.insert(fish.id);
+        }
+        if (drone.position.y <= SURFACE_DEPTH) {
+            state.savedScans[drone.player] |= drone.scans;
+            drone.scans.clear();
+        }
+    }
+
+    steerMonsters(state);
+    state.turn++;
+}
+
+bool isCommandSafe(const SimState &state, int droneIndex, DroneCommand command, int turns) {
+    SimState future = state;
+    DroneCommands commands;
+    commands.fill(DroneCommand::wait(false));
+    commands[droneIndex] = command;
+    FORI(turns) {
+        simulateTick(future, commands);
+        if (future.drones[droneIndex].emergency)
+            return false;
+    }
+    return true;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <array>
+
+#include "config.hpp"
+#include "coord.hpp"
+#include "creature.hpp"
+
+struct GameState;
+
+// Game rules.
+const int MAP_SIZE = 10000;
+const int SURFACE_DEPTH = 500;
+const int DRONE_MOVE_SPEED = 600;
+const int DRONE_SINK_SPEED = 300;
+const int DRONE_EMERGENCY_SPEED = 300;
+const int MAX_BATTERY = 30;
+const int LIGHT_BATTERY_COST = 5;
+const int SCAN_RADIUS = 800;
+const int LIGHT_SCAN_RADIUS = 2000;
+const int FISH_SWIM_SPEED = 200;
+const int FISH_FLEE_SPEED = 400;
+const int FISH_FLEE_RADIUS = 1400;
+const int MONSTER_SPEED = 270;
+const int MONSTER_CHASE_SPEED = 540;
+const int MONSTER_KILL_RADIUS = 500;
+const int MONSTER_MIN_DEPTH = 2500;
+
+// Depth range a creature of the given type never leaves.
+int getHabitatTop(Type type);
+int getHabitatBottom(Type type);
+
+const int MAX_SIM_DRONES = 4;
+const int MAX_SIM_FISH = 24;
+const int MAX_SIM_MONSTERS = 8;
+
+struct SimDrone {
+    int id;
+    // 0 for us, 1 for the foe.
+    int player;
+    Coord position;
+    int battery;
+    bool emergency;
+    bool light;
+    IntSet scans;
+};
+
+struct SimCreature {
+    int id;
+    Type type;
+    Coord position;
+    Coord velocity;
+};
+
+struct DroneCommand {
+    static DroneCommand wait(bool light) { return DroneCommand{true, Coord{0, 0}, light}; }
+    static DroneCommand move(Coord target, bool light) { return DroneCommand{false, target, light}; }
+
+    bool idle;
+    Coord target;
+    bool light;
+};
+using DroneCommands = array<DroneCommand, MAX_SIM_DRONES>;
+
+// Everything the tick simulator knows about the game, in fixed size arrays so a snapshot is a plain copy. Only
+// creatures with a known position are simulated.
+struct SimState {
+    static SimState fromGame(const GameState &game);
+    int findDrone(int droneId) const;
+
+    array<SimDrone, MAX_SIM_DRONES> drones;
+    int droneCount;
+    array<SimCreature, MAX_SIM_FISH> fish;
+    int fishCount;
+    array<SimCreature, MAX_SIM_MONSTERS> monsters;
+    int monsterCount;
+    array<IntSet, 2> savedScans;
+    int turn;
+};
+
+// Plays one game turn: drones move or sink (or rise while in emergency), battery and light, monster collisions,
+// fish and monster movement inside their habitats, scans and surfacing. commands is indexed like state.drones.
+void simulateTick(SimState &state, const DroneCommands &commands);
+// Repeats command for one drone for up to turns ticks, everybody else waiting in the dark. False when the drone
+// ends up in emergency mode.
+bool isCommandSafe(const SimState &state, int droneIndex, DroneCommand command, int turns);
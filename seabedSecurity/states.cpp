@@ -8,26 +8,29 @@
 
 /****** GameConfig ******/
 GameConfig& GameConfig::get() {
-    static GameConfig gameConfig(true);
+    static GameConfig gameConfig(false);
     return gameConfig;
 }
 
 GameConfig::GameConfig(bool initialize) {
     if (initialize)
-        parseInput(cin);
+        parseInput(InputReader::get());
 }
 
 void GameConfig::parseInput(istream& in) {
-    int creatureCount;
-    in >> creatureCount;
-    in.ignore();
+    parseWithReader(in, [this](InputReader& reader) { parseInput(reader); });
+}
+
+void GameConfig::parseInput(InputReader& in) {
+    int creatureCount = in.readInt();
 
     creatures.clear();
     enemies.clear();
     FORI(creatureCount) {
         Creature creature;
-        in >> creature.id >> reinterpret_cast<int &>(creature.color) >> reinterpret_cast<int &>(creature.type);
-        in.ignore();
+        creature.id = in.readInt();
+        creature.color = static_cast<Color>(in.readInt());
+        creature.type = static_cast<Type>(in.readInt());
         if (creature.type != Type::ENEMY)
             creatures.insert(creature);
         else
@@ -36,14 +39,11 @@ void GameConfig::parseInput(istream& in) {
 }
 
 /****** PlayerState ******/
-void PlayerState::parseDrones(istream& in) {
-    int droneCount;
-    in >> droneCount;
-    in.ignore();
+void PlayerState::parseDrones(InputReader& in) {
+    int droneCount = in.readInt();
 
     FORI(droneCount) {
-        int droneId;
-        in >> droneId;
+        int droneId = in.readInt();
         auto droneIter = getDroneState(droneId);
         if (droneIter != drones.end()) {
             droneIter->parseInput(in);
@@ -55,30 +55,23 @@ void PlayerState::parseDrones(istream& in) {
     }
 }
 
-void PlayerState::parseScans(istream& in) {
-    int scanCount;
-    in >> scanCount;
-    in.ignore();
+void PlayerState::parseScans(InputReader& in) {
+    int scanCount = in.readInt();
 
     FORI(scanCount) {
-        int id;
-        in >> id;
-        in.ignore();
+        int id = in.readInt();
         totalScans.insert(id);
     }
 }
 
-void PlayerState::parseDronesRadar(istream& in) {
-    int blipCount;
-    in >> blipCount;
-    in.ignore();
+void PlayerState::parseDronesRadar(InputReader& in) {
+    int blipCount = in.readInt();
 
     FORI(blipCount) {
-        int droneId;
-        int creatureId;
-        string radar;
-        in >> droneId >> creatureId >> radar;
-        in.ignore();
+        int droneId = in.readInt();
+        int creatureId = in.readInt();
+        char radar[4];
+        in.readToken(radar, sizeof(radar));
 
         auto droneIter = getDroneState(droneId);
         droneIter->bleeps[getQuadrant(radar)].insert(creatureId);
@@ -93,42 +86,29 @@ void PlayerState::calculateRemainingCreatures() {
     GameConfig& config = GameConfig::get();
 
     IntSet presentCreaturesIds;
-    for (auto &drone : drones)
-        for (auto &qPairs : drone.bleeps)
-            for (int creatureId : qPairs.second)
-                if (!config.enemies.count(creatureId))
-                    presentCreaturesIds.insert(creatureId);
-
-    IntSet knownCreatureIds;
+    IntSet knownCreatureIds = totalScans;
     for (auto &drone : drones) {
-        for (int creatureId : drone.currentScans)
-            knownCreatureIds.insert(creatureId);
+        presentCreaturesIds |= drone.bleeps.all();
+        knownCreatureIds |= drone.currentScans;
     }
-    for (int creatureId : totalScans)
-        knownCreatureIds.insert(creatureId);
 
-    remainingCreatures.clear();
-    for (auto &creature : presentCreaturesIds)
-        if (!knownCreatureIds.count(creature))
-            remainingCreatures.insert(creature);
+    remainingCreatures = presentCreaturesIds - config.enemies - knownCreatureIds;
 }
 
 /****** GameState ******/
-GameState& GameState::get() {
-    static GameState gameState(false);
-    return gameState;
-}
-
 GameState::GameState(bool initialize) {
     if (initialize)
-        parseInput(cin);
+        parseInput(InputReader::get());
 }
 
 void GameState::parseInput(istream& in) {
-    in >> own.score;
-    in.ignore();
-    in >> foe.score;
-    in.ignore();
+    parseWithReader(in, [this](InputReader& reader) { parseInput(reader); });
+}
+
+void GameState::parseInput(InputReader& in) {
+    PROFILE_ZONE("parse");
+    own.score = in.readInt();
+    foe.score = in.readInt();
 
     own.parseScans(in);
     foe.parseScans(in);
@@ -139,15 +119,12 @@ void GameState::parseInput(istream& in) {
     own.parseDronesRadar(in);
 }
 
-void GameState::parseDronesScans(istream& in) {
-    int scanCount;
-    in >> scanCount;
-    in.ignore();
+void GameState::parseDronesScans(InputReader& in) {
+    int scanCount = in.readInt();
 
     FORI(scanCount) {
-        int droneId, creatureId;
-        in >> droneId >> creatureId;
-        in.ignore();
+        int droneId = in.readInt();
+        int creatureId = in.readInt();
 
         auto droneIter = own.getDroneState(droneId);
         if (droneIter == own.drones.end()) {
@@ -158,20 +135,19 @@ void GameState::parseDronesScans(istream& in) {
     }
 }
 
-void GameState::parseVisibleEntities(istream& in) {
+void GameState::parseVisibleEntities(InputReader& in) {
     visibleCreatures.clear();
     visibleEnemies.clear();
 
-    int visibleCreatureCount;
-    cin >> visibleCreatureCount;
-    cin.ignore();
+    int visibleCreatureCount = in.readInt();
 
     FORI(visibleCreatureCount) {
         CreatureState creatureState;
-        cin >> creatureState.id;
-        cin >> creatureState.position.x >> creatureState.position.y;
-        cin >> creatureState.velocity.x >> creatureState.velocity.y;
-        cin.ignore();
+        creatureState.id = in.readInt();
+        creatureState.position.x = in.readInt();
+        creatureState.position.y = in.readInt();
+        creatureState.velocity.x = in.readInt();
+        creatureState.velocity.y = in.readInt();
 
         if (GameConfig::get().enemies.count(creatureState.id))
             visibleEnemies.insert(creatureState);
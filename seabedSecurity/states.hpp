@@ -1,27 +1,27 @@
 #pragma once
 
-#include <vector>
 #include <istream>
+#include <type_traits>
 
+#include "../common/inputReader.hpp"
 #include "config.hpp"
 #include "creature.hpp"
-
-struct DroneState;
-using DroneStateVec = vector<DroneState>;
+#include "drone.hpp"
 
 struct GameConfig {
     static GameConfig& get();
     GameConfig(bool initialize = false);
     void parseInput(istream& in);
+    void parseInput(InputReader& in);
 
     CreatureSet creatures;
     IntSet enemies;
 };
 
 struct PlayerState {
-    void parseDrones(istream& in);
-    void parseScans(istream& in);
-    void parseDronesRadar(istream& in);
+    void parseDrones(InputReader& in);
+    void parseScans(InputReader& in);
+    void parseDronesRadar(InputReader& in);
 
     DroneStateVec::iterator getDroneState(int droneId);
     void calculateRemainingCreatures();
@@ -32,16 +32,18 @@ struct PlayerState {
     IntSet remainingCreatures;
 };
 
+// Everything known about the current turn. It is trivially copyable, so a snapshot for search is a plain copy and
+// restoring it is an assignment.
 struct GameState {
-    static GameState& get();
     GameState(bool initialize = false);
     void parseInput(istream& in);
-    void parseDronesScans(istream& in);
-    void parseVisibleEntities(istream& in);
+    void parseInput(InputReader& in);
+    void parseDronesScans(InputReader& in);
+    void parseVisibleEntities(InputReader& in);
 
     PlayerState own;
     PlayerState foe;
     CreatureStateSet visibleCreatures;
     CreatureStateSet visibleEnemies;
 };
-
+static_assert(is_trivially_copyable_v<GameState>);
@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "sweep.hpp"
+
+namespace {
+    // GCC/clang vector extensions. Four floats fit the SSE registers every x86-64 target has.
+    typedef float Lanes __attribute__((vector_size(SWEEP_LANES * sizeof(float))));
+    typedef int Mask __attribute__((vector_size(SWEEP_LANES * sizeof(int))));
+
+    Lanes broadcast(float value) {
+        return Lanes{} + value;
+    }
+
+    Lanes load(const float *values) {
+        Lanes lanes;
+        memcpy(&lanes, values, sizeof(lanes));
+        return lanes;
+    }
+
+    // Lanes set to -1 hit at least one monster. With p the drone relative to the monster and v their relative
+    // motion, the squared distance |p + v t|^2 is smallest either at an end of the tick or at t = -p.v / v.v, where
+    // it is below r^2 exactly when (p.v)^2 >= v.v (p.p - r^2). No division and no branch per lane.
+    Mask sweepBlock(Coord position, const MonsterSweep &monsters, float radius2, Lanes dx, Lanes dy) {
+        Mask hit = Mask{};
+        Lanes r2 = broadcast(radius2);
+        FORN(m, monsters.count) {
+            float px = position.x - monsters.x[m];
+            float py = position.y - monsters.y[m];
+            float start = px * px + py * py - radius2;
+            if (start <= 0)
+                return hit | -1;
+
+            Lanes vx = dx - monsters.vx[m];
+            Lanes vy = dy - monsters.vy[m];
+            Lanes endX = vx + px;
+            Lanes endY = vy + py;
+            Lanes vv = vx * vx + vy * vy;
+            Lanes pv = vx * px + vy * py;
+            Mask atEnd = endX * endX + endY * endY <= r2;
+            Mask inside = (pv < broadcast(0)) & (-pv < vv) & (pv * pv >= vv * start);
+            hit |= atEnd | inside;
+        }
+        return hit;
+    }
+}
+
+bool segmentsCollide(Coord droneFrom, Coord droneTo, Coord monsterFrom, Coord monsterVelocity, int radius) {
+    double px = droneFrom.x - monsterFrom.x;
+    double py = droneFrom.y - monsterFrom.y;
+    double vx = (droneTo.x - droneFrom.x) - monsterVelocity.x;
+    double vy = (droneTo.y - droneFrom.y) - monsterVelocity.y;
+    double speed2 = vx * vx + vy * vy;
+    double t = speed2 > 0 ? clamp(-(px * vx + py * vy) / speed2, 0.0, 1.0) : 0;
+    double cx = px + vx * t;
+    double cy = py + vy * t;
+    return cx * cx + cy * cy <= static_cast<double>(radius) * radius;
+}
+
+void MonsterSweep::clear() {
+    count = 0;
+}
+
+void MonsterSweep::add(Coord position, Coord velocity) {
+    if (count == MAX_SWEPT_MONSTERS)
+        return;
+    x[count] = position.x;
+    y[count] = position.y;
+    vx[count] = velocity.x;
+    vy[count] = velocity.y;
+    count++;
+}
+
+void MonsterSweep::load(const CreatureStateSet &monsters) {
+    clear();
+    for (const CreatureState &monster : monsters)
+        add(monster.position, monster.velocity);
+}
+
+HeadingSearch::HeadingSearch(int headingCount, int speed) : headingCount(min(headingCount, MAX_HEADINGS)) {
+    dx.fill(0);
+    dy.fill(0);
+    FORI(this->headingCount) {
+        double angle = 2 * M_PI * i / this->headingCount;
+        dx[i] = speed * cos(angle);
+        dy[i] = speed * sin(angle);
+    }
+}
+
+Coord HeadingSearch::heading(Coord position, int index) const {
+    return Coord{position.x + static_cast<int>(round(dx[index])), position.y + static_cast<int>(round(dy[index]))};
+}
+
+void HeadingSearch::sweep(Coord position, const MonsterSweep &monsters, int radius,
+                          array<bool, MAX_HEADINGS> &safe) const {
+    float radius2 = static_cast<float>(radius) * radius;
+    for (int block = 0; block < headingCount; block += SWEEP_LANES) {
+        Mask hit = sweepBlock(position, monsters, radius2, load(&dx[block]), load(&dy[block]));
+        for (int lane = 0; lane < SWEEP_LANES && block + lane < headingCount; lane++)
+            safe[block + lane] = hit[lane] == 0;
+    }
+}
+
+optional<Coord> HeadingSearch::closestSafe(Coord position, Coord target, const MonsterSweep &monsters,
+                                           int radius) const {
+    float radius2 = static_cast<float>(radius) * radius;
+    float offsetX = position.x - target.x;
+    float offsetY = position.y - target.y;
+    int best = -1;
+    float bestDistance = 0;
+    for (int block = 0; block < headingCount; block += SWEEP_LANES) {
+        Lanes headingX = load(&dx[block]);
+        Lanes headingY = load(&dy[block]);
+        Mask hit = sweepBlock(position, monsters, radius2, headingX, headingY);
+        Lanes toTargetX = headingX + offsetX;
+        Lanes toTargetY = headingY + offsetY;
+        Lanes distance = toTargetX * toTargetX + toTargetY * toTargetY;
+        for (int lane = 0; lane < SWEEP_LANES && block + lane < headingCount; lane++) {
+            if (hit[lane] == 0 && (best < 0 || distance[lane] < bestDistance)) {
+                best = block + lane;
+                bestDistance = distance[lane];
+            }
+        }
+    }
+    if (best < 0)
+        return {};
+    return heading(position, best);
+}
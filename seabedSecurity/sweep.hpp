@@ -0,0 +1,44 @@
+#pragma once
+
+#include <array>
+#include <optional>
+
+#include "config.hpp"
+#include "coord.hpp"
+#include "creature.hpp"
+
+const int MAX_SWEPT_MONSTERS = 16;
+const int SWEEP_LANES = 4;
+const int MAX_HEADINGS = 72;
+
+// Exact closest approach between a drone moving from droneFrom to droneTo and a monster moving by monsterVelocity
+// during the same tick. True when they get within radius of each other at any time of the tick.
+bool segmentsCollide(Coord droneFrom, Coord droneTo, Coord monsterFrom, Coord monsterVelocity, int radius);
+
+// Monster positions and velocities laid out for the vectorized heading sweep.
+struct MonsterSweep {
+    void clear();
+    void add(Coord position, Coord velocity);
+    void load(const CreatureStateSet &monsters);
+
+    array<float, MAX_SWEPT_MONSTERS> x;
+    array<float, MAX_SWEPT_MONSTERS> y;
+    array<float, MAX_SWEPT_MONSTERS> vx;
+    array<float, MAX_SWEPT_MONSTERS> vy;
+    int count = 0;
+};
+
+// headingCount evenly spread full speed moves, tested SWEEP_LANES headings at a time against every monster.
+struct HeadingSearch {
+    HeadingSearch(int headingCount, int speed);
+
+    Coord heading(Coord position, int index) const;
+    // safe[i] is set when heading i stays out of radius of every monster this tick.
+    void sweep(Coord position, const MonsterSweep &monsters, int radius, array<bool, MAX_HEADINGS> &safe) const;
+    // The safe heading ending closest to target, nothing when all of them collide.
+    optional<Coord> closestSafe(Coord position, Coord target, const MonsterSweep &monsters, int radius) const;
+
+    int headingCount;
+    alignas(16) array<float, MAX_HEADINGS> dx;
+    alignas(16) array<float, MAX_HEADINGS> dy;
+};
@@ -0,0 +1,32 @@
+#include "targetChoices.hpp"
+#include "drone.hpp"
+#include "droneBehaviors.hpp"
+
+TargetChoices& TargetChoices::get() {
+    static TargetChoices targetChoices(EVALUATION_THREADS);
+    return targetChoices;
+}
+
+TargetChoices::TargetChoices(int threadCount) : pool(threadCount) {
+}
+
+void TargetChoices::evaluate(const PlayerState &state, const CreatureStateSet &visibleEnemies) {
+    PROFILE_ZONE("targets");
+    choices.resize(state.drones.size() * QUADRANT_COUNT);
+    pool.parallelFor(choices.size(), [&](int index, int) {
+        const DroneState &drone = state.drones[index / QUADRANT_COUNT];
+        Quadrant quadrant = static_cast<Quadrant>(index % QUADRANT_COUNT);
+        choices[index] = TargetChoice{drone.id, quadrant, scoreTargetChoice(drone, quadrant, state, visibleEnemies)};
+    });
+}
+
+optional<Quadrant> TargetChoices::getBest(int droneId) const {
+    const TargetChoice *best = nullptr;
+    for (auto &choice : choices)
+        if (choice.droneId == droneId && choice.score > 0 && (!best || choice.score > best->score))
+            best = &choice;
+
+    if (best)
+        return best->quadrant;
+    return {};
+}
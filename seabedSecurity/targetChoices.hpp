@@ -0,0 +1,26 @@
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include "../common/threadPool.hpp"
+#include "config.hpp"
+#include "states.hpp"
+
+struct TargetChoice {
+    int droneId;
+    Quadrant quadrant;
+    double score;
+};
+
+// Scores of every own drone x quadrant pair for the current turn. Pairs are evaluated in parallel on the pool, each
+// writing its own slot, so the table is laid out drone by drone in quadrant order no matter which thread ran what.
+struct TargetChoices {
+    static TargetChoices& get();
+    TargetChoices(int threadCount);
+    void evaluate(const PlayerState &state, const CreatureStateSet &visibleEnemies);
+    optional<Quadrant> getBest(int droneId) const;
+
+    ThreadPool pool;
+    vector<TargetChoice> choices;
+};
@@ -0,0 +1,9 @@
+#pragma once
+
+// Hand-picked before there was a tuner. `make tune` overwrites this file once it finds values that beat these.
+namespace Tuned {
+    const int AVOID_DISTANCE = 1200;
+    const int FLEE_DISTANCE = 800;
+    const int DARK_DISTANCE = 2000;
+    const float DRIFT_RATIO = 0.1f;
+}